@@ -1,12 +1,14 @@
 #include "ChatClient.h"
+#include "VideoFrame.h"
 #include <iostream>
 #include <functional>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
 
-ChatClient::ChatClient(const std::string& host, int port) 
-    : m_host(host), m_port(port), m_connected(false), m_running(false) {
+ChatClient::ChatClient(const std::string& host, int port, bool viewer) 
+    : m_host(host), m_port(port), m_viewer(viewer), m_videoRows(0), m_connected(false), m_running(false),
+      m_reconnecting(false), m_reconnectAttempts(0), m_rng(std::random_device{}()) {
     
     m_client.set_access_channels(websocketpp::log::alevel::all);
     m_client.clear_access_channels(websocketpp::log::alevel::frame_payload);
@@ -26,19 +28,14 @@ ChatClient::~ChatClient() {
 
 bool ChatClient::connect() {
     try {
-        std::string uri = "ws://" + m_host + ":" + std::to_string(m_port);
+        // Keeps run() alive between a server-initiated close and the reconnect
+        m_client.start_perpetual();
         
-        websocketpp::lib::error_code ec;
-        auto con = m_client.get_connection(uri, ec);
-        
-        if (ec) {
-            std::cerr << "Connection error: " << ec.message() << std::endl;
+        if (!openConnection()) {
+            m_client.stop_perpetual();
             return false;
         }
         
-        m_connection = con->get_handle();
-        m_client.connect(con);
-        
         std::thread clientThread([this]() {
             m_client.run();
         });
@@ -50,12 +47,23 @@ bool ChatClient::connect() {
         
         if (!m_connected) {
             std::cerr << "Connection timeout" << std::endl;
+            m_client.stop_perpetual();
             return false;
         }
         
+        if (m_viewer) {
+            // Hide the cursor while frames are drawn in place
+            std::lock_guard<std::mutex> lock(m_outputMutex);
+            std::cout << "\033[?25l" << std::flush;
+            return true;
+        }
+        
         std::cout << "Enter your username: ";
         std::getline(std::cin, m_username);
         
+        // Registers the name with the server so others can message us directly
+        sendMessage("", MessageType::USER_JOIN);
+        
         return true;
         
     } catch (const std::exception& e) {
@@ -64,6 +72,43 @@ bool ChatClient::connect() {
     }
 }
 
+bool ChatClient::openConnection() {
+    std::string uri = "ws://" + m_host + ":" + std::to_string(m_port);
+    
+    websocketpp::lib::error_code ec;
+    auto con = m_client.get_connection(uri, ec);
+    
+    if (ec) {
+        std::cerr << "Connection error: " << ec.message() << std::endl;
+        return false;
+    }
+    
+    // Lets the server coalesce several messages into a single frame, or
+    // asks for the video broadcast instead of chat
+    con->add_subprotocol(m_viewer ? VIDEO_SUBPROTOCOL : BATCH_SUBPROTOCOL);
+    
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        m_connection = con->get_handle();
+    }
+    m_client.connect(con);
+    return true;
+}
+
+void ChatClient::scheduleReconnect() {
+    std::uniform_int_distribution<int> jitter(0, RECONNECT_JITTER_MS);
+    int delay = jitter(m_rng) + m_reconnectAttempts * RECONNECT_BACKOFF_MS;
+    
+    m_client.set_timer(delay, [this](const websocketpp::lib::error_code& ec) {
+        if (ec || !m_reconnecting) return;
+        
+        if (!openConnection()) {
+            m_reconnecting = false;
+            m_running = false;
+        }
+    });
+}
+
 void ChatClient::run() {
     if (!m_connected) return;
     
@@ -75,18 +120,28 @@ void ChatClient::run() {
 }
 
 void ChatClient::disconnect() {
-    if (!m_connected) return;
-    
     m_running = false;
-    m_connected = false;
+    m_reconnecting = false;
+    m_client.stop_perpetual();
     
-    try {
-        m_client.close(m_connection, websocketpp::close::status::normal, "Client disconnecting");
-    } catch (const std::exception& e) {
-        std::cerr << "Error during disconnect: " << e.what() << std::endl;
+    if (m_connected) {
+        m_connected = false;
+        
+        try {
+            std::lock_guard<std::mutex> lock(m_connectionMutex);
+            m_client.close(m_connection, websocketpp::close::status::normal, "Client disconnecting");
+        } catch (const std::exception& e) {
+            std::cerr << "Error during disconnect: " << e.what() << std::endl;
+        }
     }
     
-    if (m_inputThread.joinable()) {
+    if (m_viewer) {
+        std::lock_guard<std::mutex> lock(m_outputMutex);
+        std::cout << "\033[0m\033[?25h\033[" << m_videoRows + 1 << ";1H" << std::flush;
+    }
+    
+    // inputLoop() itself ends by calling disconnect()
+    if (m_inputThread.joinable() && m_inputThread.get_id() != std::this_thread::get_id()) {
         m_inputThread.join();
     }
 }
@@ -94,29 +149,55 @@ void ChatClient::disconnect() {
 void ChatClient::onOpen(connection_hdl hdl) {
     std::lock_guard<std::mutex> lock(m_outputMutex);
     m_connected = true;
-    std::cout << "Connected to chat server!" << std::endl;
+    
+    if (m_reconnecting) {
+        m_reconnecting = false;
+        m_reconnectAttempts = 0;
+        std::cout << "Reconnected to chat server!" << std::endl;
+        // The new server process only knows us once we join again
+        if (!m_viewer) {
+            sendMessage("", MessageType::USER_JOIN);
+        }
+    } else {
+        std::cout << "Connected to chat server!" << std::endl;
+    }
 }
 
 void ChatClient::onClose(connection_hdl hdl) {
     std::lock_guard<std::mutex> lock(m_outputMutex);
     m_connected = false;
+    
+    client_type::connection_ptr con = m_client.get_con_from_hdl(hdl);
+    if (m_running && con->get_remote_close_code() == websocketpp::close::status::going_away) {
+        std::cout << "Server is restarting, reconnecting..." << std::endl;
+        m_reconnecting = true;
+        m_reconnectAttempts = 0;
+        scheduleReconnect();
+        return;
+    }
+    
     m_running = false;
     std::cout << "Disconnected from chat server." << std::endl;
 }
 
 void ChatClient::onMessage(connection_hdl hdl, message_ptr msg) {
     try {
-        Message chatMsg = Message::deserialize(msg->get_payload());
-        
-        std::lock_guard<std::mutex> lock(m_outputMutex);
-        auto time = std::chrono::system_clock::to_time_t(chatMsg.getTimestamp());
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&time), "%H:%M:%S");
+        const std::string& payload = msg->get_payload();
         
-        if (chatMsg.getType() == MessageType::SYSTEM) {
-            std::cout << "[SYSTEM] " << chatMsg.getContent() << std::endl;
+        if (msg->get_opcode() == websocketpp::frame::opcode::binary) {
+            renderVideoFrame(payload);
+        } else if (Message::isBatch(payload)) {
+            std::vector<Message> batch = Message::deserializeBatch(payload);
+            
+            std::lock_guard<std::mutex> lock(m_outputMutex);
+            for (const Message& chatMsg : batch) {
+                printMessage(chatMsg);
+            }
         } else {
-            std::cout << "[" << ss.str() << "] " << chatMsg.getUsername() << ": " << chatMsg.getContent() << std::endl;
+            Message chatMsg = Message::deserialize(payload);
+            
+            std::lock_guard<std::mutex> lock(m_outputMutex);
+            printMessage(chatMsg);
         }
         
     } catch (const std::exception& e) {
@@ -124,23 +205,79 @@ void ChatClient::onMessage(connection_hdl hdl, message_ptr msg) {
     }
 }
 
+void ChatClient::printMessage(const Message& chatMsg) {
+    auto time = std::chrono::system_clock::to_time_t(chatMsg.getTimestamp());
+    std::stringstream ss;
+    ss << std::put_time(std::localtime(&time), "%H:%M:%S");
+    
+    if (chatMsg.getType() == MessageType::SYSTEM) {
+        std::cout << "[SYSTEM] " << chatMsg.getContent() << std::endl;
+    } else if (chatMsg.getType() == MessageType::DIRECT_MESSAGE) {
+        std::cout << "[" << ss.str() << "] (private) " << chatMsg.getUsername() << ": " << chatMsg.getContent() << std::endl;
+    } else {
+        std::cout << "[" << ss.str() << "] " << chatMsg.getUsername() << ": " << chatMsg.getContent() << std::endl;
+    }
+}
+
+void ChatClient::renderVideoFrame(const std::string& payload) {
+    bool keyframe = false;
+    uint16_t totalRows = 0;
+    std::vector<VideoFrame::Row> rows;
+    
+    if (!VideoFrame::decode(payload, keyframe, totalRows, rows)) {
+        std::cerr << "Ignoring malformed video frame" << std::endl;
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    
+    // Each changed row is redrawn in place; colors are reset per row
+    // because rows arrive independently of their neighbours
+    std::string screen;
+    if (keyframe && totalRows != m_videoRows) {
+        screen += "\033[2J";
+        m_videoRows = totalRows;
+    }
+    for (const VideoFrame::Row& row : rows) {
+        screen += "\033[" + std::to_string(row.index + 1) + ";1H";
+        screen += row.text;
+        screen += "\033[0m\033[K";
+    }
+    
+    std::cout.write(screen.data(), screen.size());
+    std::cout.flush();
+}
+
 void ChatClient::onFail(connection_hdl hdl) {
     std::lock_guard<std::mutex> lock(m_outputMutex);
-    std::cout << "Connection failed." << std::endl;
     m_connected = false;
+    
+    if (m_reconnecting && ++m_reconnectAttempts < RECONNECT_ATTEMPTS) {
+        scheduleReconnect();
+        return;
+    }
+    
+    if (m_reconnecting) {
+        m_reconnecting = false;
+        std::cout << "Could not reconnect to chat server. Press Enter to exit." << std::endl;
+    } else {
+        std::cout << "Connection failed." << std::endl;
+    }
     m_running = false;
 }
 
-void ChatClient::sendMessage(const std::string& content) {
+void ChatClient::sendMessage(const std::string& content, MessageType type, const std::string& recipient) {
     if (!m_connected) return;
     
     try {
         Message msg;
-        msg.setType(MessageType::CHAT);
+        msg.setType(type);
         msg.setUsername(m_username);
         msg.setContent(content);
+        msg.setRecipient(recipient);
         msg.setTimestamp(std::chrono::system_clock::now());
         
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
         m_client.send(m_connection, msg.serialize(), websocketpp::frame::opcode::text);
         
     } catch (const std::exception& e) {
@@ -151,14 +288,28 @@ void ChatClient::sendMessage(const std::string& content) {
 void ChatClient::inputLoop() {
     std::string input;
     
-    while (m_running && m_connected) {
-        std::getline(std::cin, input);
+    // Keeps reading while a reconnect is in progress
+    while (m_running) {
+        if (!std::getline(std::cin, input)) break;
+        if (!m_running) break;
         
         if (input == "quit" || input == "exit") {
             m_running = false;
             break;
         }
-        if (!input.empty()) {
+        if (m_viewer) {
+            continue;
+        }
+        if (input.rfind("/msg ", 0) == 0) {
+            // /msg <user> <text>
+            size_t nameEnd = input.find(' ', 5);
+            if (nameEnd == std::string::npos || nameEnd == 5) {
+                std::lock_guard<std::mutex> lock(m_outputMutex);
+                std::cout << "Usage: /msg <user> <text>" << std::endl;
+                continue;
+            }
+            sendMessage(input.substr(nameEnd + 1), MessageType::DIRECT_MESSAGE, input.substr(5, nameEnd - 5));
+        } else if (!input.empty()) {
             sendMessage(input);
         }
     }
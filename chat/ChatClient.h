@@ -7,10 +7,14 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <vector>
+#include <random>
 
 class ChatClient {
 public:
-    ChatClient(const std::string& host, int port);
+    // A viewer only watches the server's video broadcast: it never joins the
+    // chat and renders binary VideoFrame messages to the terminal
+    ChatClient(const std::string& host, int port, bool viewer = false);
     ~ChatClient();
     
     bool connect();
@@ -22,12 +26,23 @@ private:
     typedef websocketpp::connection_hdl connection_hdl;
     typedef client_type::message_ptr message_ptr;
     
+    // Reconnects after the server closes with going_away (hot restart).
+    // The first attempt waits a random 0..RECONNECT_JITTER_MS so a draining
+    // server's clients don't all land on the new process at once.
+    static const int RECONNECT_ATTEMPTS = 5;
+    static const int RECONNECT_JITTER_MS = 2000;
+    static const int RECONNECT_BACKOFF_MS = 1000;
+    
+    bool openConnection();
+    void scheduleReconnect();
     void onOpen(connection_hdl hdl);
     void onClose(connection_hdl hdl);
     void onMessage(connection_hdl hdl, message_ptr msg);
     void onFail(connection_hdl hdl);
+    void printMessage(const Message& chatMsg);
+    void renderVideoFrame(const std::string& payload);
     
-    void sendMessage(const std::string& content);
+    void sendMessage(const std::string& content, MessageType type = MessageType::CHAT, const std::string& recipient = std::string());
     void inputLoop();
     
     client_type m_client;
@@ -35,8 +50,14 @@ private:
     std::string m_host;
     int m_port;
     std::string m_username;
+    bool m_viewer;
+    int m_videoRows;
     std::thread m_inputThread;
     std::atomic<bool> m_connected;
     std::atomic<bool> m_running;
+    std::atomic<bool> m_reconnecting;
+    int m_reconnectAttempts;
+    std::mt19937 m_rng;
+    std::mutex m_connectionMutex;
     std::mutex m_outputMutex;
 };
\ No newline at end of file
@@ -1,18 +1,25 @@
 #include "ChatServer.h"
+#include "Handoff.h"
+#include "VideoFrame.h"
 #include <iostream>
 #include <functional>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <algorithm>
+#include <cstdio>
 
-ChatServer::ChatServer(int port) : m_port(port), m_running(false) {
+ChatServer::ChatServer(int port)
+    : m_port(port), m_running(false), m_batchWindow(-1), m_flushScheduled(false),
+      m_accepting(false), m_handoffFd(-1), m_handoffChannel(-1), m_drainSeconds(10), m_drainBatch(1),
+      m_handedOff(false), m_draining(false), m_drained(false) {
     m_server.set_access_channels(websocketpp::log::alevel::all);
     m_server.clear_access_channels(websocketpp::log::alevel::frame_payload);
     m_server.set_error_channels(websocketpp::log::elevel::all);
     
     m_server.init_asio();
-    m_server.set_reuse_addr(true);
     
+    m_server.set_validate_handler(std::bind(&ChatServer::onValidate, this, std::placeholders::_1));
     m_server.set_open_handler(std::bind(&ChatServer::onOpen, this, std::placeholders::_1));
     m_server.set_close_handler(std::bind(&ChatServer::onClose, this, std::placeholders::_1));
     m_server.set_message_handler(std::bind(&ChatServer::onMessage, this, std::placeholders::_1, std::placeholders::_2));
@@ -22,12 +29,76 @@ ChatServer::~ChatServer() {
     stop();
 }
 
+void ChatServer::setBatchWindow(int milliseconds) {
+    m_batchWindow = milliseconds;
+}
+
 void ChatServer::start() {
     if (m_running) return;
     
-    m_server.listen(m_port);
-    m_server.start_accept();
+    // The acceptor is owned here rather than by websocketpp so its socket
+    // can be handed to another process
+    using websocketpp::lib::asio::ip::tcp;
+    m_acceptor.reset(new acceptor_type(m_server.get_io_service()));
+    tcp::endpoint endpoint(tcp::v6(), static_cast<unsigned short>(m_port));
+    m_acceptor->open(endpoint.protocol());
+    m_acceptor->set_option(websocketpp::lib::asio::socket_base::reuse_address(true));
+    m_acceptor->bind(endpoint);
+    m_acceptor->listen();
+    
+    runServerThread();
+    std::cout << "Chat server started on port " << m_port << std::endl;
+}
+
+bool ChatServer::startFromHandoff(const std::string& socketPath) {
+    if (m_running) return false;
+    
+    int channel = Handoff::connect(socketPath);
+    if (channel < 0) return false;
+    
+    int listenFd = -1;
+    std::string snapshot;
+    if (!Handoff::receiveSocket(channel, listenFd, snapshot)) {
+        std::cerr << "Handoff failed: no listening socket received" << std::endl;
+        Handoff::close(channel);
+        return false;
+    }
+    
+    using websocketpp::lib::asio::ip::tcp;
+    websocketpp::lib::asio::error_code ec;
+    m_acceptor.reset(new acceptor_type(m_server.get_io_service()));
+    m_acceptor->assign(Handoff::isIPv6(listenFd) ? tcp::v6() : tcp::v4(), listenFd, ec);
+    
+    if (ec) {
+        std::cerr << "Handoff failed: " << ec.message() << std::endl;
+        Handoff::close(listenFd);
+        Handoff::close(channel);
+        return false;
+    }
+    
+    try {
+        restoreSnapshot(snapshot);
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring unreadable state snapshot: " << e.what() << std::endl;
+    }
+    
+    // Start accepting before the ack so there is no moment without an acceptor
+    runServerThread();
+    Handoff::sendAck(channel);
+    Handoff::close(channel);
+    
+    std::cout << "Chat server took over port " << m_acceptor->local_endpoint().port()
+              << " (" << m_history.size() << " history messages, "
+              << m_migratingUsers.size() << " users migrating)" << std::endl;
+    return true;
+}
+
+void ChatServer::runServerThread() {
     m_running = true;
+    m_accepting = true;
+    m_stats = DeliveryStats();
+    m_stats.cpuStart = std::clock();
+    startAccept();
     
     m_serverThread = std::thread([this]() {
         try {
@@ -36,28 +107,244 @@ void ChatServer::start() {
             std::cerr << "Server error: " << e.what() << std::endl;
         }
     });
+}
+
+void ChatServer::startAccept() {
+    server_type::connection_ptr con = m_server.get_connection();
+    m_acceptor->async_accept(con->get_raw_socket(), [this, con](const websocketpp::lib::asio::error_code& ec) {
+        handleAccept(con, ec);
+    });
+}
+
+void ChatServer::handleAccept(server_type::connection_ptr con, const websocketpp::lib::asio::error_code& ec) {
+    if (ec) {
+        // Aborted means the acceptor was closed for a handoff or shutdown
+        if (ec == websocketpp::lib::asio::error::operation_aborted) return;
+        std::cerr << "Accept error: " << ec.message() << std::endl;
+    } else {
+        con->start();
+    }
     
-    std::cout << "Chat server started on port " << m_port << std::endl;
+    if (m_accepting) {
+        startAccept();
+    }
 }
 
 void ChatServer::stop() {
     if (!m_running) return;
     
     m_running = false;
+    
+    if (m_handoffFd >= 0) {
+        // Unblocks accept() or a stalled handoff in the handoff thread
+        std::lock_guard<std::mutex> lock(m_handoffMutex);
+        Handoff::shutdown(m_handoffFd);
+        Handoff::shutdown(m_handoffChannel);
+    }
+    if (m_handoffThread.joinable()) {
+        m_handoffThread.join();
+    }
+    if (m_handoffFd >= 0) {
+        Handoff::close(m_handoffFd);
+        m_handoffFd = -1;
+        
+        // After a handoff the successor has already rebound the path
+        if (!m_handedOff) {
+            std::remove(m_handoffPath.c_str());
+        }
+    }
+    
     m_server.stop();
     
     if (m_serverThread.joinable()) {
         m_serverThread.join();
     }
     
+    printDeliveryStats();
     std::cout << "Chat server stopped" << std::endl;
 }
 
+bool ChatServer::enableHandoff(const std::string& socketPath, int drainSeconds) {
+    if (!m_running || m_handoffFd >= 0) return false;
+    
+    m_handoffFd = Handoff::listen(socketPath);
+    if (m_handoffFd < 0) return false;
+    
+    m_handoffPath = socketPath;
+    m_drainSeconds = std::max(drainSeconds, 1);
+    m_handoffThread = std::thread(&ChatServer::handoffLoop, this);
+    
+    std::cout << "Waiting for a successor on " << socketPath << std::endl;
+    return true;
+}
+
+void ChatServer::handoffLoop() {
+    while (true) {
+        int channel = Handoff::accept(m_handoffFd);
+        if (channel < 0) return;
+        
+        {
+            std::lock_guard<std::mutex> lock(m_handoffMutex);
+            if (!m_running) {
+                Handoff::close(channel);
+                return;
+            }
+            m_handoffChannel = channel;
+        }
+        
+        bool handedOff = Handoff::sendSocket(channel, m_acceptor->native_handle(), makeSnapshot()) &&
+                         Handoff::waitAck(channel);
+        
+        {
+            std::lock_guard<std::mutex> lock(m_handoffMutex);
+            m_handoffChannel = -1;
+            Handoff::close(channel);
+        }
+        
+        if (handedOff) break;
+        if (!m_running) return;
+        
+        // The path stays bound, so another successor can try again
+        std::cerr << "Handoff failed, waiting for another successor" << std::endl;
+    }
+    
+    // The path is left in place: the successor unlinks and rebinds it when
+    // it enables its own handoff, and removing it here could race with that.
+    // stop() checks this flag, since the drain itself starts a little later.
+    m_handedOff = true;
+    std::cout << "Listening socket handed off, draining connections over "
+              << m_drainSeconds << "s" << std::endl;
+    m_server.get_io_service().post([this]() { beginDrain(); });
+}
+
+std::string ChatServer::makeSnapshot() {
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    
+    nlohmann::json snapshot;
+    snapshot["drainSeconds"] = m_drainSeconds;
+    snapshot["roster"] = nlohmann::json::array();
+    for (const auto& entry : m_userIndex) {
+        snapshot["roster"].push_back(entry.first);
+    }
+    
+    snapshot["history"] = nlohmann::json::array();
+    for (const payload_ptr& payload : m_history) {
+        snapshot["history"].push_back(*payload);
+    }
+    
+    return snapshot.dump();
+}
+
+void ChatServer::restoreSnapshot(const std::string& snapshot) {
+    nlohmann::json j = nlohmann::json::parse(snapshot);
+    
+    // Names that haven't come back once the old server has drained and the
+    // clients' reconnect backoff has run out belong to ordinary new users
+    int windowMs = j.value("drainSeconds", 10) * 1000 + MIGRATION_GRACE_MS;
+    m_server.set_timer(windowMs, [this](const websocketpp::lib::error_code& ec) {
+        if (ec) return;
+        
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        if (!m_migratingUsers.empty()) {
+            std::cout << m_migratingUsers.size() << " users did not reconnect after the restart" << std::endl;
+        }
+        m_migratingUsers.clear();
+    });
+    
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    for (const auto& username : j.at("roster")) {
+        m_migratingUsers.insert(username.get<std::string>());
+    }
+    for (const auto& payload : j.at("history")) {
+        m_history.push_back(std::make_shared<const std::string>(payload.get<std::string>()));
+    }
+}
+
+void ChatServer::beginDrain() {
+    m_accepting = false;
+    websocketpp::lib::asio::error_code ec;
+    m_acceptor->close(ec);
+    
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    m_draining = true;
+    
+    size_t steps = static_cast<size_t>(m_drainSeconds) * 1000 / DRAIN_INTERVAL_MS;
+    m_drainBatch = std::max<size_t>(1, (m_connections.size() + steps - 1) / steps);
+    
+    m_server.get_io_service().post([this]() { drainStep(); });
+}
+
+void ChatServer::drainStep() {
+    std::vector<connection_hdl> closing;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        if (m_connections.empty()) {
+            m_drained = true;
+            std::cout << "All connections drained" << std::endl;
+            return;
+        }
+        
+        for (auto& entry : m_connections) {
+            if (closing.size() >= m_drainBatch) break;
+            if (!entry.second.closing) {
+                entry.second.closing = true;
+                closing.push_back(entry.first);
+            }
+        }
+    }
+    
+    // going_away tells clients to reconnect, which now lands on the new process
+    for (const connection_hdl& hdl : closing) {
+        websocketpp::lib::error_code ec;
+        m_server.close(hdl, websocketpp::close::status::going_away, "Server restarting", ec);
+    }
+    
+    m_server.set_timer(DRAIN_INTERVAL_MS, [this](const websocketpp::lib::error_code& ec) {
+        if (!ec) drainStep();
+    });
+}
+
+bool ChatServer::onValidate(connection_hdl hdl) {
+    server_type::connection_ptr con = m_server.get_con_from_hdl(hdl);
+    const std::vector<std::string>& protocols = con->get_requested_subprotocols();
+    
+    // Video frames are pre-framed for RFC 6455, so older drafts can't view
+    if (std::find(protocols.begin(), protocols.end(), VIDEO_SUBPROTOCOL) != protocols.end() && con->get_version() >= 13) {
+        con->select_subprotocol(VIDEO_SUBPROTOCOL);
+    } else if (std::find(protocols.begin(), protocols.end(), BATCH_SUBPROTOCOL) != protocols.end()) {
+        con->select_subprotocol(BATCH_SUBPROTOCOL);
+    }
+    
+    return true;
+}
+
 void ChatServer::onOpen(connection_hdl hdl) {
     std::lock_guard<std::mutex> lock(m_connectionMutex);
-    m_connections.insert(hdl);
+    // Starts unbound; the user index only learns about it at USER_JOIN
+    ConnectionState& state = m_connections[hdl];
+    state = ConnectionState();
+    const std::string& subprotocol = m_server.get_con_from_hdl(hdl)->get_subprotocol();
+    state.batching = subprotocol == BATCH_SUBPROTOCOL;
+    state.viewer = subprotocol == VIDEO_SUBPROTOCOL;
+    
+    std::cout << (state.viewer ? "Viewer" : "Client") << " connected. Total connections: " << m_connections.size() << std::endl;
     
-    std::cout << "Client connected. Total connections: " << m_connections.size() << std::endl;
+    if (state.viewer) {
+        // Catch up from the latest keyframe so the picture is complete at once
+        if (!m_videoKeyframe) return;
+        
+        try {
+            m_server.send(hdl, m_videoKeyframe);
+            for (const message_ptr& delta : m_videoDeltas) {
+                m_server.send(hdl, delta);
+            }
+            state.needsKeyframe = false;
+            m_stats.videoFrames += 1 + m_videoDeltas.size();
+        } catch (const std::exception& e) {
+            std::cerr << "Error sending keyframe: " << e.what() << std::endl;
+        }
+        return;
+    }
     
     Message welcomeMsg;
     welcomeMsg.setType(MessageType::SYSTEM);
@@ -66,24 +353,89 @@ void ChatServer::onOpen(connection_hdl hdl) {
     
     try {
         m_server.send(hdl, welcomeMsg.serialize(), websocketpp::frame::opcode::text);
+        m_stats.messages++;
+        m_stats.frames++;
     } catch (const std::exception& e) {
         std::cerr << "Error sending welcome message: " << e.what() << std::endl;
     }
 }
 
 void ChatServer::onClose(connection_hdl hdl) {
-    std::lock_guard<std::mutex> lock(m_connectionMutex);
-    m_connections.erase(hdl);
+    std::string leftUser;
+    {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        auto it = m_connections.find(hdl);
+        if (it != m_connections.end()) {
+            std::string username = it->second.username;
+            unbindUser(it->second);
+            m_connections.erase(it);
+            
+            // Not announced while draining since the user is just moving to
+            // the new process
+            if (!username.empty() && !m_draining) {
+                leftUser = username;
+            }
+        }
+        
+        std::cout << "Client disconnected. Total connections: " << m_connections.size() << std::endl;
+    }
     
-    std::cout << "Client disconnected. Total connections: " << m_connections.size() << std::endl;
+    if (!leftUser.empty()) {
+        broadcastMessage(Message(MessageType::SYSTEM, "", leftUser + " left the chat"));
+    }
 }
 
 void ChatServer::onMessage(connection_hdl hdl, message_ptr msg) {
     try {
         Message chatMsg = Message::deserialize(msg->get_payload());
         
-        std::cout << "[" << chatMsg.getUsername() << "]: " << chatMsg.getContent() << std::endl;
-        broadcastMessage(chatMsg, hdl);
+        if (chatMsg.getType() == MessageType::USER_JOIN) {
+            bool migrated = false;
+            {
+                std::lock_guard<std::mutex> lock(m_connectionMutex);
+                auto it = m_connections.find(hdl);
+                if (it == m_connections.end()) return;
+                
+                // A second connection under the same name would receive that
+                // user's direct messages, so names are first come first served
+                if (!bindUser(hdl, it->second, chatMsg.getUsername())) {
+                    sendSystemMessage(hdl, it->second, "The name '" + chatMsg.getUsername() +
+                                      "' is not available, reconnect with another one");
+                    return;
+                }
+                migrated = m_migratingUsers.erase(chatMsg.getUsername()) > 0;
+                
+                // Migrating users already saw the history before the restart
+                if (!migrated) {
+                    for (const payload_ptr& payload : m_history) {
+                        queueSend(hdl, it->second, payload);
+                    }
+                }
+            }
+            
+            std::cout << chatMsg.getUsername() << (migrated ? " reconnected" : " joined") << std::endl;
+            if (!migrated) {
+                broadcastMessage(Message(MessageType::SYSTEM, "", chatMsg.getUsername() + " joined the chat"), hdl);
+            }
+        } else if (chatMsg.getType() == MessageType::DIRECT_MESSAGE) {
+            sendDirectMessage(chatMsg, hdl);
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(m_connectionMutex);
+                auto it = m_connections.find(hdl);
+                if (it == m_connections.end()) return;
+                
+                if (it->second.username.empty()) {
+                    sendSystemMessage(hdl, it->second, "Join the chat before sending messages");
+                    return;
+                }
+                // The bound name replaces whatever the client claims to be
+                chatMsg.setUsername(it->second.username);
+            }
+            
+            std::cout << "[" << chatMsg.getUsername() << "]: " << chatMsg.getContent() << std::endl;
+            broadcastMessage(chatMsg, hdl);
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error processing message: " << e.what() << std::endl;
     }
@@ -92,20 +444,228 @@ void ChatServer::onMessage(connection_hdl hdl, message_ptr msg) {
 void ChatServer::broadcastMessage(const Message& message, connection_hdl sender) {
     std::lock_guard<std::mutex> lock(m_connectionMutex);
     
-    std::string serialized = message.serialize();
+    // Serialized once and shared by every recipient's pending queue
+    payload_ptr serialized = std::make_shared<const std::string>(message.serialize());
+    
+    if (message.getType() == MessageType::CHAT) {
+        m_history.push_back(serialized);
+        if (m_history.size() > HISTORY_SIZE) {
+            m_history.pop_front();
+        }
+    }
     
     for (auto it = m_connections.begin(); it != m_connections.end();) {
         try {
-            if (sender.lock() && it->lock() == sender.lock()) {
+            if (it->second.viewer || (sender.lock() && it->first.lock() == sender.lock())) {
                 ++it;
                 continue;
             }
             
-            m_server.send(*it, serialized, websocketpp::frame::opcode::text);
+            queueSend(it->first, it->second, serialized);
             ++it;
         } catch (const std::exception& e) {
             std::cerr << "Error broadcasting to client: " << e.what() << std::endl;
+            unbindUser(it->second);
             it = m_connections.erase(it);
         }
     }
-}
\ No newline at end of file
+}
+
+void ChatServer::sendDirectMessage(const Message& message, connection_hdl sender) {
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    
+    auto senderIt = m_connections.find(sender);
+    if (senderIt == m_connections.end()) return;
+    ConnectionState& senderState = senderIt->second;
+    
+    try {
+        if (senderState.username.empty()) {
+            sendSystemMessage(sender, senderState, "Join the chat before sending private messages");
+            return;
+        }
+        
+        // One hash lookup no matter how many users are online
+        auto recipient = m_userIndex.find(message.getRecipient());
+        if (recipient == m_userIndex.end()) {
+            sendSystemMessage(sender, senderState, message.getRecipient() + " is not online");
+            return;
+        }
+        
+        // The bound name is used as the sender so it can't be spoofed
+        Message direct(MessageType::DIRECT_MESSAGE, senderState.username, message.getContent());
+        direct.setRecipient(message.getRecipient());
+        direct.setTimestamp(message.getTimestamp());
+        payload_ptr serialized = std::make_shared<const std::string>(direct.serialize());
+        auto it = m_connections.find(recipient->second);
+        if (it != m_connections.end()) {
+            queueSend(recipient->second, it->second, serialized);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error sending direct message: " << e.what() << std::endl;
+    }
+}
+
+void ChatServer::sendSystemMessage(connection_hdl hdl, ConnectionState& state, const std::string& content) {
+    Message systemMsg(MessageType::SYSTEM, "", content);
+    queueSend(hdl, state, std::make_shared<const std::string>(systemMsg.serialize()));
+}
+
+bool ChatServer::bindUser(connection_hdl hdl, ConnectionState& state, const std::string& username) {
+    if (username.empty()) return false;
+    if (state.username == username) return true;
+    
+    if (m_userIndex.find(username) != m_userIndex.end()) return false;
+    
+    unbindUser(state);
+    state.username = username;
+    m_userIndex[username] = hdl;
+    return true;
+}
+
+void ChatServer::unbindUser(ConnectionState& state) {
+    if (state.username.empty()) return;
+    
+    m_userIndex.erase(state.username);
+    state.username.clear();
+}
+
+void ChatServer::queueSend(connection_hdl hdl, ConnectionState& state, const payload_ptr& payload) {
+    if (m_batchWindow < 0 || !state.batching) {
+        m_server.send(hdl, *payload, websocketpp::frame::opcode::text);
+        m_stats.messages++;
+        m_stats.frames++;
+        return;
+    }
+    
+    state.pending.push_back(payload);
+    if (m_flushScheduled) return;
+    
+    m_flushScheduled = true;
+    if (m_batchWindow == 0) {
+        // Runs after the handlers already queued in this loop turn
+        m_server.get_io_service().post([this]() { flushPending(); });
+    } else {
+        m_server.set_timer(m_batchWindow, [this](const websocketpp::lib::error_code& ec) {
+            if (!ec) flushPending();
+        });
+    }
+}
+
+void ChatServer::broadcastVideoFrame(const std::string& payload, bool keyframe) {
+    if (!m_running) return;
+    
+    message_ptr frame = makeVideoMessage(payload);
+    
+    // Sent from the server thread like all other traffic
+    m_server.get_io_service().post([this, frame, keyframe]() {
+        std::lock_guard<std::mutex> lock(m_connectionMutex);
+        
+        if (keyframe) {
+            m_videoKeyframe = frame;
+            m_videoDeltas.clear();
+        } else if (m_videoKeyframe) {
+            m_videoDeltas.push_back(frame);
+        }
+        
+        for (auto it = m_connections.begin(); it != m_connections.end();) {
+            if (!it->second.viewer) {
+                ++it;
+                continue;
+            }
+            
+            try {
+                sendVideoFrame(it->first, it->second, frame, keyframe);
+                ++it;
+            } catch (const std::exception& e) {
+                std::cerr << "Error sending video frame: " << e.what() << std::endl;
+                unbindUser(it->second);
+                it = m_connections.erase(it);
+            }
+        }
+    });
+}
+
+ChatServer::message_ptr ChatServer::makeVideoMessage(const std::string& payload) {
+    // Building the frame header here marks the message as prepared, so
+    // websocketpp writes this one buffer to every viewer instead of copying
+    // the payload per connection. Server frames are never masked and
+    // compression is not enabled, so the header is the same for everyone.
+    message_ptr msg = std::make_shared<message_ptr::element_type>(
+        message_ptr::element_type::con_msg_man_ptr(), websocketpp::frame::opcode::binary, payload.size());
+    msg->set_payload(payload);
+    
+    websocketpp::frame::basic_header header(websocketpp::frame::opcode::binary, payload.size(), true, false);
+    websocketpp::frame::extended_header extended(payload.size());
+    msg->set_header(websocketpp::frame::prepare_header(header, extended));
+    msg->set_prepared(true);
+    return msg;
+}
+
+void ChatServer::sendVideoFrame(connection_hdl hdl, ConnectionState& state, const message_ptr& frame, bool keyframe) {
+    // Deltas only make sense on top of the frames before them
+    if (!keyframe && state.needsKeyframe) {
+        m_stats.videoDropped++;
+        return;
+    }
+    
+    // A viewer that can't keep up skips to the next keyframe instead of
+    // queuing frames that would be stale by the time they arrive
+    if (m_server.get_con_from_hdl(hdl)->get_buffered_amount() > VIDEO_LAG_BYTES) {
+        state.needsKeyframe = true;
+        m_stats.videoDropped++;
+        return;
+    }
+    
+    m_server.send(hdl, frame);
+    state.needsKeyframe = false;
+    m_stats.videoFrames++;
+}
+
+void ChatServer::flushPending() {
+    std::lock_guard<std::mutex> lock(m_connectionMutex);
+    m_flushScheduled = false;
+    
+    for (auto it = m_connections.begin(); it != m_connections.end();) {
+        std::vector<payload_ptr>& pending = it->second.pending;
+        if (pending.empty()) {
+            ++it;
+            continue;
+        }
+        
+        try {
+            // A lone message goes out as-is, anything more as one batch frame
+            if (pending.size() == 1) {
+                m_server.send(it->first, *pending.front(), websocketpp::frame::opcode::text);
+            } else {
+                m_server.send(it->first, Message::serializeBatch(pending), websocketpp::frame::opcode::text);
+            }
+            m_stats.messages += pending.size();
+            m_stats.frames++;
+            pending.clear();
+            ++it;
+        } catch (const std::exception& e) {
+            std::cerr << "Error flushing to client: " << e.what() << std::endl;
+            unbindUser(it->second);
+            it = m_connections.erase(it);
+        }
+    }
+}
+
+void ChatServer::printDeliveryStats() {
+    if (m_stats.videoFrames > 0 || m_stats.videoDropped > 0) {
+        std::cout << "Delivered " << m_stats.videoFrames << " video frames, dropped "
+                  << m_stats.videoDropped << " for lagging viewers" << std::endl;
+    }
+    
+    if (m_stats.messages == 0) return;
+    
+    double cpuSeconds = static_cast<double>(std::clock() - m_stats.cpuStart) / CLOCKS_PER_SEC;
+    
+    // These are WebSocket frames handed to websocketpp, not socket writes:
+    // websocketpp already gathers frames queued behind an in-flight write
+    // into one async_write, so frames are an upper bound on write calls
+    std::cout << std::fixed << std::setprecision(2)
+              << "Delivered " << m_stats.messages << " messages in " << m_stats.frames << " frames ("
+              << static_cast<double>(m_stats.messages) / m_stats.frames << " messages/frame), "
+              << cpuSeconds * 1e6 / m_stats.messages << " us CPU/message" << std::endl;
+}
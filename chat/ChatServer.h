@@ -3,33 +3,135 @@
 #include "Message.h"
 #include <websocketpp/config/asio_no_tls.hpp>
 #include <websocketpp/server.hpp>
-#include <set>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <ctime>
 
 class ChatServer {
 public:
     ChatServer(int port);
     ~ChatServer();
     
+    // Coalesce outbound messages per connection: -1 disables batching, 0
+    // flushes at the end of the current event loop turn, N > 0 waits N ms.
+    // Only clients that negotiated BATCH_SUBPROTOCOL receive batches.
+    void setBatchWindow(int milliseconds);
+    
     void start();
     void stop();
     
+    // Hot restart: a server with a handoff socket waits for a successor that
+    // calls startFromHandoff() on the same path. The successor receives the
+    // listening socket, rosters and recent history; the old server stops
+    // accepting and closes its connections in small batches over
+    // drainSeconds so clients reconnect gradually instead of all at once.
+    // During the drain the room is split between the two processes: chat
+    // is not relayed between them, direct messages to a user who already
+    // moved report "not online", and messages sent on the old process after
+    // the snapshot are missing from the successor's history.
+    bool enableHandoff(const std::string& socketPath, int drainSeconds = 10);
+    bool startFromHandoff(const std::string& socketPath);
+    bool isDrained() const { return m_drained; }
+    
+    // Sends an encoded VideoFrame to every viewer (VIDEO_SUBPROTOCOL). The
+    // frame is framed once and the same buffer is queued on each connection.
+    // Viewers whose send buffer exceeds VIDEO_LAG_BYTES drop frames until
+    // the next keyframe; new viewers start from the latest keyframe.
+    void broadcastVideoFrame(const std::string& payload, bool keyframe);
+    
 private:
     typedef websocketpp::server<websocketpp::config::asio> server_type;
     typedef websocketpp::connection_hdl connection_hdl;
     typedef server_type::message_ptr message_ptr;
+    typedef std::shared_ptr<const std::string> payload_ptr;
+    typedef websocketpp::lib::asio::ip::tcp::acceptor acceptor_type;
+    
+    static const size_t HISTORY_SIZE = 50;
+    static const int DRAIN_INTERVAL_MS = 100;
+    // How long past the old server's drain window a name still counts as migrating
+    static const int MIGRATION_GRACE_MS = 15000;
+    static const size_t VIDEO_LAG_BYTES = 512 * 1024;
+    
+    struct ConnectionState {
+        std::string username;
+        bool batching = false;
+        bool closing = false;
+        bool viewer = false;
+        bool needsKeyframe = true;
+        std::vector<payload_ptr> pending;
+    };
     
+    struct DeliveryStats {
+        unsigned long long messages = 0;
+        unsigned long long frames = 0; // WebSocket frames sent, not syscalls
+        unsigned long long videoFrames = 0;
+        unsigned long long videoDropped = 0;
+        std::clock_t cpuStart = 0;
+    };
+    
+    void runServerThread();
+    void startAccept();
+    void handleAccept(server_type::connection_ptr con, const websocketpp::lib::asio::error_code& ec);
+    void handoffLoop();
+    std::string makeSnapshot();
+    void restoreSnapshot(const std::string& snapshot);
+    void beginDrain();
+    void drainStep();
+    
+    bool onValidate(connection_hdl hdl);
     void onOpen(connection_hdl hdl);
     void onClose(connection_hdl hdl);
     void onMessage(connection_hdl hdl, message_ptr msg);
     void broadcastMessage(const Message& message, connection_hdl sender = connection_hdl());
+    void sendDirectMessage(const Message& message, connection_hdl sender);
+    void sendSystemMessage(connection_hdl hdl, ConnectionState& state, const std::string& content);
+    bool bindUser(connection_hdl hdl, ConnectionState& state, const std::string& username);
+    void unbindUser(ConnectionState& state);
+    void queueSend(connection_hdl hdl, ConnectionState& state, const payload_ptr& payload);
+    message_ptr makeVideoMessage(const std::string& payload);
+    void sendVideoFrame(connection_hdl hdl, ConnectionState& state, const message_ptr& frame, bool keyframe);
+    void flushPending();
+    void printDeliveryStats();
     
     server_type m_server;
     std::thread m_serverThread;
-    std::set<connection_hdl, std::owner_less<connection_hdl>> m_connections;
+    std::map<connection_hdl, ConnectionState, std::owner_less<connection_hdl>> m_connections;
+    // Username (bound at USER_JOIN) -> the one connection holding it
+    std::unordered_map<std::string, connection_hdl> m_userIndex;
     std::mutex m_connectionMutex;
     int m_port;
-    bool m_running;
-};
\ No newline at end of file
+    std::atomic<bool> m_running;
+    int m_batchWindow;
+    bool m_flushScheduled;
+    DeliveryStats m_stats;
+    
+    std::unique_ptr<acceptor_type> m_acceptor;
+    bool m_accepting;
+    std::deque<payload_ptr> m_history;
+    // Users that were online in the previous process; their reconnect is not announced
+    std::unordered_set<std::string> m_migratingUsers;
+    std::string m_handoffPath;
+    int m_handoffFd;
+    // Channel to a successor while a handoff is in progress, so stop() can
+    // interrupt it
+    int m_handoffChannel;
+    std::mutex m_handoffMutex;
+    std::thread m_handoffThread;
+    int m_drainSeconds;
+    size_t m_drainBatch;
+    // Set as soon as the successor acks, before the drain starts
+    std::atomic<bool> m_handedOff;
+    std::atomic<bool> m_draining;
+    std::atomic<bool> m_drained;
+    
+    // Latest keyframe and the deltas since, replayed to viewers that join mid-stream
+    message_ptr m_videoKeyframe;
+    std::vector<message_ptr> m_videoDeltas;
+};
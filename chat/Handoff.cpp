@@ -0,0 +1,228 @@
+#include "Handoff.h"
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifdef _WIN32
+
+int Handoff::listen(const std::string& path) {
+    std::cerr << "Hot restart is not supported on Windows" << std::endl;
+    return -1;
+}
+
+int Handoff::accept(int listenFd) { return -1; }
+bool Handoff::sendSocket(int channelFd, int socketFd, const std::string& snapshot) { return false; }
+bool Handoff::waitAck(int channelFd) { return false; }
+
+int Handoff::connect(const std::string& path) {
+    std::cerr << "Hot restart is not supported on Windows" << std::endl;
+    return -1;
+}
+
+bool Handoff::receiveSocket(int channelFd, int& socketFd, std::string& snapshot) { return false; }
+bool Handoff::sendAck(int channelFd) { return false; }
+bool Handoff::isIPv6(int socketFd) { return false; }
+void Handoff::close(int fd) {}
+void Handoff::shutdown(int fd) {}
+
+#else
+
+namespace {
+
+const char ACK = 'K';
+
+// Bounds every read and write on a handoff channel, so a peer that stalls
+// mid-handoff can't block either process forever
+const int CHANNEL_TIMEOUT_SECONDS = 10;
+
+bool makeAddress(const std::string& path, sockaddr_un& addr) {
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Handoff socket path too long: " << path << std::endl;
+        return false;
+    }
+    
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+void setChannelTimeout(int fd) {
+    timeval timeout;
+    timeout.tv_sec = CHANNEL_TIMEOUT_SECONDS;
+    timeout.tv_usec = 0;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool readAll(int fd, char* data, size_t size) {
+    while (size > 0) {
+        ssize_t got = ::read(fd, data, size);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        data += got;
+        size -= got;
+    }
+    return true;
+}
+
+}
+
+int Handoff::listen(const std::string& path) {
+    sockaddr_un addr;
+    if (!makeAddress(path, addr)) return -1;
+    
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    
+    // A previous process may have left its socket file behind
+    ::unlink(path.c_str());
+    
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 1) < 0) {
+        std::cerr << "Could not listen on handoff socket " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return -1;
+    }
+    
+    return fd;
+}
+
+int Handoff::accept(int listenFd) {
+    while (true) {
+        int fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd >= 0) {
+            setChannelTimeout(fd);
+            return fd;
+        }
+        if (errno != EINTR) return -1;
+    }
+}
+
+bool Handoff::sendSocket(int channelFd, int socketFd, const std::string& snapshot) {
+    // The length prefix travels in the same message as the descriptor
+    uint32_t length = htonl(static_cast<uint32_t>(snapshot.size()));
+    iovec iov;
+    iov.iov_base = &length;
+    iov.iov_len = sizeof(length);
+    
+    char control[CMSG_SPACE(sizeof(int))];
+    std::memset(control, 0, sizeof(control));
+    
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &socketFd, sizeof(int));
+    
+    if (::sendmsg(channelFd, &msg, MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(length))) {
+        return false;
+    }
+    
+    return writeAll(channelFd, snapshot.data(), snapshot.size());
+}
+
+bool Handoff::waitAck(int channelFd) {
+    char ack = 0;
+    return readAll(channelFd, &ack, 1) && ack == ACK;
+}
+
+int Handoff::connect(const std::string& path) {
+    sockaddr_un addr;
+    if (!makeAddress(path, addr)) return -1;
+    
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Could not connect to handoff socket " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return -1;
+    }
+    
+    setChannelTimeout(fd);
+    return fd;
+}
+
+bool Handoff::receiveSocket(int channelFd, int& socketFd, std::string& snapshot) {
+    uint32_t length = 0;
+    iovec iov;
+    iov.iov_base = &length;
+    iov.iov_len = sizeof(length);
+    
+    char control[CMSG_SPACE(sizeof(int))];
+    std::memset(control, 0, sizeof(control));
+    
+    msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    
+    ssize_t got;
+    do {
+        got = ::recvmsg(channelFd, &msg, 0);
+    } while (got < 0 && errno == EINTR);
+    
+    if (got != static_cast<ssize_t>(sizeof(length))) return false;
+    
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+        return false;
+    }
+    std::memcpy(&socketFd, CMSG_DATA(cmsg), sizeof(int));
+    
+    snapshot.resize(ntohl(length));
+    return snapshot.empty() || readAll(channelFd, &snapshot[0], snapshot.size());
+}
+
+bool Handoff::sendAck(int channelFd) {
+    return writeAll(channelFd, &ACK, 1);
+}
+
+bool Handoff::isIPv6(int socketFd) {
+    sockaddr_storage addr;
+    socklen_t length = sizeof(addr);
+    return ::getsockname(socketFd, reinterpret_cast<sockaddr*>(&addr), &length) == 0 && addr.ss_family == AF_INET6;
+}
+
+void Handoff::close(int fd) {
+    if (fd >= 0) ::close(fd);
+}
+
+void Handoff::shutdown(int fd) {
+    if (fd >= 0) ::shutdown(fd, SHUT_RDWR);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+// Hands a listening socket and a state snapshot from a running server to
+// its replacement over a Unix domain socket (SCM_RIGHTS). POSIX only; on
+// Windows every call fails. Reads and writes on an accepted or connected
+// channel time out after a few seconds.
+class Handoff {
+public:
+    // Old process side
+    static int listen(const std::string& path);
+    static int accept(int listenFd);
+    static bool sendSocket(int channelFd, int socketFd, const std::string& snapshot);
+    static bool waitAck(int channelFd);
+    
+    // New process side
+    static int connect(const std::string& path);
+    static bool receiveSocket(int channelFd, int& socketFd, std::string& snapshot);
+    static bool sendAck(int channelFd);
+    
+    static bool isIPv6(int socketFd);
+    static void close(int fd);
+    static void shutdown(int fd);
+};
@@ -12,6 +12,9 @@ std::string Message::serialize() const {
     j["type"] = static_cast<int>(m_type);
     j["username"] = m_username;
     j["content"] = m_content;
+    if (!m_recipient.empty()) {
+        j["recipient"] = m_recipient;
+    }
     j["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
         m_timestamp.time_since_epoch()).count();
     
@@ -19,21 +22,63 @@ std::string Message::serialize() const {
 }
 
 Message Message::deserialize(const std::string& json) {
+    try {
+        return fromJson(nlohmann::json::parse(json));
+    } catch (const std::exception& e) {
+        throw std::runtime_error("Failed to deserialize message: " + std::string(e.what()));
+    }
+}
+
+std::string Message::serializeBatch(const std::vector<std::shared_ptr<const std::string>>& serialized) {
+    size_t size = serialized.size() + 1;
+    for (const auto& payload : serialized) {
+        size += payload->size();
+    }
+    
+    // Entries are already valid JSON, so they're spliced in without reparsing
+    std::string batch;
+    batch.reserve(size);
+    batch += '[';
+    for (size_t i = 0; i < serialized.size(); ++i) {
+        if (i > 0) batch += ',';
+        batch += *serialized[i];
+    }
+    batch += ']';
+    
+    return batch;
+}
+
+bool Message::isBatch(const std::string& payload) {
+    return !payload.empty() && payload[0] == '[';
+}
+
+std::vector<Message> Message::deserializeBatch(const std::string& json) {
     try {
         nlohmann::json j = nlohmann::json::parse(json);
         
-        Message msg;
-        msg.m_type = static_cast<MessageType>(j["type"].get<int>());
-        msg.m_username = j["username"].get<std::string>();
-        msg.m_content = j["content"].get<std::string>();
-        
-        auto timestamp_ms = j["timestamp"].get<long long>();
-        msg.m_timestamp = std::chrono::system_clock::time_point(
-            std::chrono::milliseconds(timestamp_ms));
+        std::vector<Message> messages;
+        messages.reserve(j.size());
+        for (const auto& entry : j) {
+            messages.push_back(fromJson(entry));
+        }
         
-        return msg;
+        return messages;
         
     } catch (const std::exception& e) {
-        throw std::runtime_error("Failed to deserialize message: " + std::string(e.what()));
+        throw std::runtime_error("Failed to deserialize message batch: " + std::string(e.what()));
     }
-}
\ No newline at end of file
+}
+
+Message Message::fromJson(const nlohmann::json& j) {
+    Message msg;
+    msg.m_type = static_cast<MessageType>(j.at("type").get<int>());
+    msg.m_username = j.at("username").get<std::string>();
+    msg.m_content = j.at("content").get<std::string>();
+    msg.m_recipient = j.value("recipient", std::string());
+    
+    auto timestamp_ms = j.at("timestamp").get<long long>();
+    msg.m_timestamp = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(timestamp_ms));
+    
+    return msg;
+}
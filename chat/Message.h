@@ -2,13 +2,20 @@
 
 #include <string>
 #include <chrono>
+#include <memory>
+#include <vector>
 #include <nlohmann/json.hpp>
 
+// WebSocket subprotocol offered by clients that accept batched frames: a
+// JSON array of serialized messages delivered as one frame
+const char* const BATCH_SUBPROTOCOL = "uwu-chat.batch";
+
 enum class MessageType {
     CHAT,
     SYSTEM,
     USER_JOIN,
-    USER_LEAVE
+    USER_LEAVE,
+    DIRECT_MESSAGE
 };
 
 class Message {
@@ -19,19 +26,28 @@ public:
     MessageType getType() const { return m_type; }
     const std::string& getUsername() const { return m_username; }
     const std::string& getContent() const { return m_content; }
+    const std::string& getRecipient() const { return m_recipient; }
     std::chrono::system_clock::time_point getTimestamp() const { return m_timestamp; }
     
     void setType(MessageType type) { m_type = type; }
     void setUsername(const std::string& username) { m_username = username; }
     void setContent(const std::string& content) { m_content = content; }
+    void setRecipient(const std::string& recipient) { m_recipient = recipient; }
     void setTimestamp(std::chrono::system_clock::time_point timestamp) { m_timestamp = timestamp; }
     
     std::string serialize() const;
     static Message deserialize(const std::string& json);
     
+    static std::string serializeBatch(const std::vector<std::shared_ptr<const std::string>>& serialized);
+    static bool isBatch(const std::string& payload);
+    static std::vector<Message> deserializeBatch(const std::string& json);
+    
 private:
+    static Message fromJson(const nlohmann::json& j);
+    
     MessageType m_type;
     std::string m_username;
     std::string m_content;
+    std::string m_recipient;
     std::chrono::system_clock::time_point m_timestamp;
 };
\ No newline at end of file
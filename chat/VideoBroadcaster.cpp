@@ -0,0 +1,83 @@
+#include "VideoBroadcaster.h"
+#include "VideoFrame.h"
+#include "ChatServer.h"
+#include "../video/FrameTimer.h"
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+VideoBroadcaster::VideoBroadcaster(ChatServer& server, const std::string& videoPath, int frameWidth, ColorMode colorMode)
+    : m_server(server), m_videoPath(videoPath), m_converter(frameWidth, colorMode), m_frameRate(30.0), m_running(false) {
+}
+
+VideoBroadcaster::~VideoBroadcaster() {
+    stop();
+}
+
+bool VideoBroadcaster::start() {
+    if (m_running) return true;
+    
+    if (!m_capture.open(m_videoPath)) {
+        std::cerr << "Error: Could not open video file: " << m_videoPath << std::endl;
+        return false;
+    }
+    
+    double fps = m_capture.get(cv::CAP_PROP_FPS);
+    if (fps > 0) {
+        m_frameRate = fps;
+    }
+    
+    m_running = true;
+    m_thread = std::thread(&VideoBroadcaster::broadcastLoop, this);
+    
+    std::cout << "Broadcasting " << m_videoPath << " at " << m_frameRate << " fps" << std::endl;
+    return true;
+}
+
+void VideoBroadcaster::stop() {
+    m_running = false;
+    
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_capture.release();
+}
+
+void VideoBroadcaster::broadcastLoop() {
+    const long long keyframeInterval = std::max(1LL, std::llround(m_frameRate * KEYFRAME_SECONDS));
+    
+    std::vector<std::string> previous;
+    std::vector<std::string> current;
+    cv::Mat frame;
+    
+    FrameTimer timer(m_frameRate);
+    timer.start();
+    long long frameIndex = 0;
+    long long lastKeyframe = -keyframeInterval;
+    
+    while (m_running) {
+        if (!m_capture.read(frame)) {
+            // Loop the video for as long as the broadcast runs
+            m_capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+            if (!m_capture.read(frame)) {
+                std::cerr << "Error: Could not read from " << m_videoPath << std::endl;
+                break;
+            }
+        }
+        
+        // Converted once here, whatever the number of viewers
+        VideoFrame::splitRows(m_converter.convertFrameToASCII(frame), current);
+        
+        bool keyframe = frameIndex - lastKeyframe >= keyframeInterval || current.size() != previous.size();
+        if (keyframe) {
+            m_server.broadcastVideoFrame(VideoFrame::encodeKeyframe(current), true);
+            lastKeyframe = frameIndex;
+        } else if (current != previous) {
+            m_server.broadcastVideoFrame(VideoFrame::encodeDelta(previous, current), false);
+        }
+        
+        previous.swap(current);
+        timer.sleepUntil(++frameIndex);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../video/ASCIIConverter.h"
+#include <string>
+#include <thread>
+#include <atomic>
+
+class ChatServer;
+
+// Only built with CHAT_WITH_VIDEO defined. It pulls in the video module,
+// so that build also compiles ../video/ASCIIConverter.cpp and
+// ../video/FrameTimer.cpp and links OpenCV. Plain server/client builds
+// and viewer mode need neither.
+//
+// Converts a video once, in a loop, and pushes each frame to every viewer
+// connected to the server. Frames are keyframes every KEYFRAME_SECONDS and
+// row deltas otherwise; the server shares one encoded payload between all
+// viewers.
+class VideoBroadcaster {
+public:
+    VideoBroadcaster(ChatServer& server, const std::string& videoPath,
+                     int frameWidth = 100, ColorMode colorMode = ColorMode::GRAYSCALE);
+    ~VideoBroadcaster();
+    
+    bool start();
+    void stop();
+    
+private:
+    static const int KEYFRAME_SECONDS = 2;
+    
+    void broadcastLoop();
+    
+    ChatServer& m_server;
+    std::string m_videoPath;
+    ASCIIConverter m_converter;
+    cv::VideoCapture m_capture;
+    double m_frameRate;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+};
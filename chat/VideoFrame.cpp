@@ -0,0 +1,109 @@
+#include "VideoFrame.h"
+
+namespace {
+
+void putU16(std::string& out, size_t value) {
+    out += static_cast<char>((value >> 8) & 0xFF);
+    out += static_cast<char>(value & 0xFF);
+}
+
+void putU32(std::string& out, size_t value) {
+    out += static_cast<char>((value >> 24) & 0xFF);
+    out += static_cast<char>((value >> 16) & 0xFF);
+    out += static_cast<char>((value >> 8) & 0xFF);
+    out += static_cast<char>(value & 0xFF);
+}
+
+uint32_t getU(const std::string& in, size_t pos, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | static_cast<unsigned char>(in[pos + i]);
+    }
+    return value;
+}
+
+}
+
+void VideoFrame::splitRows(const std::string& ascii, std::vector<std::string>& rows) {
+    size_t count = 0;
+    size_t begin = 0;
+    
+    while (begin < ascii.size()) {
+        size_t end = ascii.find('\n', begin);
+        if (end == std::string::npos) end = ascii.size();
+        
+        if (count == rows.size()) rows.emplace_back();
+        rows[count++].assign(ascii, begin, end - begin);
+        begin = end + 1;
+    }
+    
+    rows.resize(count);
+}
+
+std::string VideoFrame::encodeKeyframe(const std::vector<std::string>& rows) {
+    return encode(KEYFRAME, rows, std::vector<bool>(rows.size(), true), rows.size());
+}
+
+std::string VideoFrame::encodeDelta(const std::vector<std::string>& previous, const std::vector<std::string>& current) {
+    std::vector<bool> changed(current.size());
+    size_t count = 0;
+    
+    for (size_t i = 0; i < current.size(); ++i) {
+        changed[i] = i >= previous.size() || previous[i] != current[i];
+        if (changed[i]) ++count;
+    }
+    
+    return encode(DELTA, current, changed, count);
+}
+
+std::string VideoFrame::encode(char type, const std::vector<std::string>& rows, const std::vector<bool>& changed, size_t count) {
+    size_t size = HEADER_SIZE;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (changed[i]) size += 6 + rows[i].size();
+    }
+    
+    std::string out;
+    out.reserve(size);
+    out += type;
+    putU16(out, rows.size());
+    putU16(out, count);
+    
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (!changed[i]) continue;
+        putU16(out, i);
+        putU32(out, rows[i].size());
+        out += rows[i];
+    }
+    
+    return out;
+}
+
+bool VideoFrame::decode(const std::string& payload, bool& keyframe, uint16_t& totalRows, std::vector<Row>& rows) {
+    if (payload.size() < HEADER_SIZE || (payload[0] != KEYFRAME && payload[0] != DELTA)) {
+        return false;
+    }
+    
+    keyframe = payload[0] == KEYFRAME;
+    totalRows = static_cast<uint16_t>(getU(payload, 1, 2));
+    size_t count = getU(payload, 3, 2);
+    size_t pos = HEADER_SIZE;
+    
+    rows.clear();
+    rows.reserve(count);
+    
+    for (size_t i = 0; i < count; ++i) {
+        if (payload.size() - pos < 6) return false;
+        
+        Row row;
+        row.index = static_cast<uint16_t>(getU(payload, pos, 2));
+        size_t length = getU(payload, pos + 2, 4);
+        pos += 6;
+        
+        if (payload.size() - pos < length || row.index >= totalRows) return false;
+        row.text.assign(payload, pos, length);
+        pos += length;
+        rows.push_back(std::move(row));
+    }
+    
+    return pos == payload.size();
+}
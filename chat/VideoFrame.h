@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// WebSocket subprotocol offered by video viewers. Viewers only receive
+// binary VideoFrame payloads, never chat traffic.
+const char* const VIDEO_SUBPROTOCOL = "uwu-chat.video";
+
+// Binary encoding of one ASCII video frame, split into terminal rows:
+//   [type 'K' or 'D'][u16 total rows][u16 row count]
+//   then per row: [u16 row index][u32 length][row bytes]
+// A keyframe carries every row; a delta only the rows that changed since
+// the previous frame. Integers are big-endian.
+class VideoFrame {
+public:
+    struct Row {
+        uint16_t index;
+        std::string text;
+    };
+    
+    // Splits converter output on '\n' into rows, reusing the vector's strings
+    static void splitRows(const std::string& ascii, std::vector<std::string>& rows);
+    
+    static std::string encodeKeyframe(const std::vector<std::string>& rows);
+    // previous and current must have the same number of rows
+    static std::string encodeDelta(const std::vector<std::string>& previous, const std::vector<std::string>& current);
+    
+    static bool decode(const std::string& payload, bool& keyframe, uint16_t& totalRows, std::vector<Row>& rows);
+    
+private:
+    static const char KEYFRAME = 'K';
+    static const char DELTA = 'D';
+    static const size_t HEADER_SIZE = 5;
+    
+    static std::string encode(char type, const std::vector<std::string>& rows, const std::vector<bool>& changed, size_t count);
+};
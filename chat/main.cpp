@@ -1,14 +1,30 @@
 #include "ChatClient.h"
 #include "ChatServer.h"
+#ifdef CHAT_WITH_VIDEO
+#include "VideoBroadcaster.h"
+#endif
 #include <iostream>
 #include <string>
 #include <thread>
 #include <chrono>
+#include <atomic>
 
 void printUsage(const std::string& programName) {
     std::cout << "Usage: " << programName << " [server|client] [options]\n";
-    std::cout << "  server <port>           - Start chat server on specified port\n";
-    std::cout << "  client <host> <port>    - Connect to chat server\n";
+    std::cout << "  server <port> [batch-ms] [--handoff <path>] [--takeover <path>]\n";
+    std::cout << "                           - Start chat server on specified port\n";
+    std::cout << "                             batch-ms coalesces messages per client (0 = per event loop turn)\n";
+    std::cout << "                             --handoff waits on <path> for a replacement process\n";
+    std::cout << "                             --takeover replaces the server waiting on <path>\n";
+    std::cout << "  client <host> <port>     - Connect to chat server\n";
+    #ifdef CHAT_WITH_VIDEO
+    std::cout << "  broadcast <port> <video> [width]\n";
+    std::cout << "                           - Start chat server that also streams the video as ASCII\n";
+    #endif
+    std::cout << "  viewer <host> <port>     - Watch a server's video broadcast\n";
+    std::cout << "\nHot restart example:\n";
+    std::cout << "  " << programName << " server 9002 --handoff /tmp/uwu-chat.sock\n";
+    std::cout << "  " << programName << " server 9002 --takeover /tmp/uwu-chat.sock --handoff /tmp/uwu-chat.sock\n";
 }
 
 int main(int argc, char* argv[]) {
@@ -20,23 +36,112 @@ int main(int argc, char* argv[]) {
     std::string mode = argv[1];
 
     if (mode == "server") {
-        if (argc != 3) {
+        if (argc < 3) {
             printUsage(argv[0]);
             return 1;
         }
 
         int port = std::stoi(argv[2]);
+        int batchWindow = -1;
+        std::string handoffPath;
+        std::string takeoverPath;
+
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--handoff" && i + 1 < argc) {
+                handoffPath = argv[++i];
+            } else if (arg == "--takeover" && i + 1 < argc) {
+                takeoverPath = argv[++i];
+            } else if (i == 3 && arg.rfind("--", 0) != 0) {
+                batchWindow = std::stoi(arg);
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
         ChatServer server(port);
+        server.setBatchWindow(batchWindow);
+        
+        if (!takeoverPath.empty()) {
+            std::cout << "Taking over chat server via " << takeoverPath << "...\n";
+            if (!server.startFromHandoff(takeoverPath)) {
+                std::cout << "Failed to take over server.\n";
+                return 1;
+            }
+        } else {
+            std::cout << "Starting chat server on port " << port << "...\n";
+            server.start();
+        }
+        
+        if (!handoffPath.empty() && server.enableHandoff(handoffPath)) {
+            // Runs until stopped by hand or until a successor has taken over
+            // and every connection has been drained
+            static std::atomic<bool> stopRequested(false);
+            std::thread([]() {
+                std::string input;
+                std::getline(std::cin, input);
+                stopRequested = true;
+            }).detach();
+            
+            std::cout << "Press Enter to stop server...\n";
+            while (!stopRequested && !server.isDrained()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+        } else {
+            std::string input;
+            std::cout << "Press Enter to stop server...\n";
+            std::getline(std::cin, input);
+        }
+        
+        server.stop();
+    }
+    #ifdef CHAT_WITH_VIDEO
+    else if (mode == "broadcast") {
+        if (argc != 4 && argc != 5) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        int port = std::stoi(argv[2]);
+        int width = argc == 5 ? std::stoi(argv[4]) : 100;
+        if (width <= 0) {
+            printUsage(argv[0]);
+            return 1;
+        }
         
+        ChatServer server(port);
         std::cout << "Starting chat server on port " << port << "...\n";
         server.start();
         
+        VideoBroadcaster broadcaster(server, argv[3], width);
+        if (!broadcaster.start()) {
+            server.stop();
+            return 1;
+        }
+        
         std::string input;
         std::cout << "Press Enter to stop server...\n";
         std::getline(std::cin, input);
         
+        broadcaster.stop();
         server.stop();
     }
+    #endif
+    else if (mode == "viewer") {
+        if (argc != 4) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        ChatClient viewer(argv[2], std::stoi(argv[3]), true);
+        
+        if (!viewer.connect()) {
+            std::cout << "Failed to connect to server.\n";
+            return 1;
+        }
+        viewer.run();
+    }
     else if (mode == "client") {
         if (argc != 4) {
             printUsage(argv[0]);
@@ -52,6 +157,7 @@ int main(int argc, char* argv[]) {
         
         if (client.connect()) {
             std::cout << "Connected! Type messages and press Enter to send. Type 'quit' to exit.\n";
+            std::cout << "Use '/msg <user> <text>' to send a private message.\n";
             client.run();
         } else {
             std::cout << "Failed to connect to server.\n";
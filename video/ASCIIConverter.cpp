@@ -0,0 +1,342 @@
+#include "ASCIIConverter.h"
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+const std::string ASCIIConverter::ASCII_CHARS = " .:-=+*#%@";
+
+namespace {
+
+const char* HALF_BLOCK = "\xE2\x96\x80"; // U+2580 upper half block
+
+// Escape sequences are looked up rather than formatted per cell
+struct EscapeTables {
+    std::string foreground256[256];
+    std::string background256[256];
+    std::string decimal[256];
+    unsigned char cubeLevel[256];
+
+    EscapeTables() {
+        for (int i = 0; i < 256; ++i) {
+            foreground256[i] = "\033[38;5;" + std::to_string(i) + "m";
+            background256[i] = "\033[48;5;" + std::to_string(i) + "m";
+            decimal[i] = std::to_string(i);
+            cubeLevel[i] = static_cast<unsigned char>((i * 5 + 127) / 255);
+        }
+    }
+};
+
+const EscapeTables& escapeTables() {
+    static const EscapeTables tables;
+    return tables;
+}
+
+}
+
+ASCIIConverter::ASCIIConverter(int frameWidth, ColorMode colorMode, bool halfBlock)
+    : frameWidth(frameWidth), colorMode(colorMode), halfBlock(halfBlock && colorMode != ColorMode::GRAYSCALE),
+      truecolorMask(0xFF), timingEnabled(false), sampledCols(0), sampledRows(0), sampledWidth(0) {
+    for (int i = 0; i < 256; ++i) {
+        glyphForLuma[i] = ASCII_CHARS[i * (ASCII_CHARS.size() - 1) / 255];
+    }
+}
+
+const std::string& ASCIIConverter::convertFrameToASCII(const cv::Mat& frame) {
+    if (!timingEnabled) {
+        sampleCells(frame);
+        cellsToASCII(cells, output);
+        return output;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    sampleCells(frame);
+    auto sampled = std::chrono::steady_clock::now();
+    cellsToASCII(cells, output);
+    auto done = std::chrono::steady_clock::now();
+
+    timings.resizeSeconds += std::chrono::duration<double>(sampled - start).count();
+    timings.quantizeSeconds += std::chrono::duration<double>(done - sampled).count();
+    return output;
+}
+
+std::string ASCIIConverter::convertFrameToASCIIMultiPass(const cv::Mat& frame) {
+    cv::Mat resized = resizeFrame(frame);
+
+    if (colorMode == ColorMode::GRAYSCALE) {
+        return pixelsToASCII(convertToGrayscale(resized));
+    }
+
+    std::string result;
+    cellsToASCII(resized, result);
+    return result;
+}
+
+int ASCIIConverter::outputHeight(int srcCols, int srcRows) const {
+    // Terminal cells are roughly twice as tall as they are wide
+    double aspect = static_cast<double>(srcRows) / srcCols;
+    int height = static_cast<int>(frameWidth * aspect * 0.5);
+
+    // Half blocks pack two pixel rows into each cell
+    if (halfBlock) {
+        height *= 2;
+    }
+
+    return std::max(height, 1);
+}
+
+void ASCIIConverter::buildAxis(int srcSize, int dstSize, SamplingAxis& axis) {
+    const uint32_t one = 1u << WEIGHT_BITS;
+    double scale = static_cast<double>(srcSize) / dstSize;
+
+    axis.start.assign(dstSize, 0);
+    axis.count.assign(dstSize, 0);
+    axis.offset.assign(dstSize, 0);
+    axis.weights.clear();
+
+    for (int i = 0; i < dstSize; ++i) {
+        double lo = i * scale;
+        double hi = std::min((i + 1) * scale, static_cast<double>(srcSize));
+        int first = std::min(static_cast<int>(lo), srcSize - 1);
+        int last = std::max(static_cast<int>(std::ceil(hi)) - 1, first);
+
+        axis.start[i] = first;
+        axis.count[i] = last - first + 1;
+        axis.offset[i] = static_cast<int>(axis.weights.size());
+
+        // Weight each source pixel by how much of it falls inside the cell.
+        // Weights are differences of rounded cumulative coverage, so none is
+        // negative and they telescope to exactly one per cell.
+        auto coverage = [&](double x) {
+            return static_cast<uint32_t>((x - lo) / (hi - lo) * one + 0.5);
+        };
+        for (int j = first; j <= last; ++j) {
+            double from = std::max(lo, static_cast<double>(j));
+            double to = std::min(hi, j + 1.0);
+            axis.weights.push_back(to > from ? coverage(to) - coverage(from) : 0);
+        }
+    }
+}
+
+void ASCIIConverter::rebuildSamplingTables(int srcCols, int srcRows) {
+    int height = outputHeight(srcCols, srcRows);
+
+    buildAxis(srcCols, frameWidth, columns);
+    buildAxis(srcRows, height, rows);
+    rowAccumulator.assign(static_cast<size_t>(frameWidth) * 3, 0);
+    cells.create(height, frameWidth, CV_8UC3);
+
+    sampledCols = srcCols;
+    sampledRows = srcRows;
+    sampledWidth = frameWidth;
+}
+
+void ASCIIConverter::sampleCells(const cv::Mat& frame) {
+    const cv::Mat* source = &frame;
+    if (frame.type() != CV_8UC3) {
+        cv::cvtColor(frame, bgrScratch, frame.channels() == 4 ? cv::COLOR_BGRA2BGR : cv::COLOR_GRAY2BGR);
+        source = &bgrScratch;
+    }
+
+    if (source->cols != sampledCols || source->rows != sampledRows || frameWidth != sampledWidth) {
+        rebuildSamplingTables(source->cols, source->rows);
+    }
+
+    const int shift = 2 * WEIGHT_BITS;
+    const uint32_t half = 1u << (shift - 1);
+
+    for (int y = 0; y < cells.rows; ++y) {
+        std::fill(rowAccumulator.begin(), rowAccumulator.end(), 0);
+
+        // Separable box filter: each source row in the cell's vertical span is
+        // reduced horizontally once and folded into the row accumulator
+        for (int r = 0; r < rows.count[y]; ++r) {
+            const uchar* src = source->ptr<uchar>(rows.start[y] + r);
+            uint32_t rowWeight = rows.weights[rows.offset[y] + r];
+            uint32_t* acc = rowAccumulator.data();
+
+            for (int x = 0; x < frameWidth; ++x, acc += 3) {
+                const uchar* pixel = src + columns.start[x] * 3;
+                const uint32_t* weight = &columns.weights[columns.offset[x]];
+                uint32_t b = 0, g = 0, red = 0;
+
+                for (int c = 0; c < columns.count[x]; ++c, pixel += 3) {
+                    b += pixel[0] * weight[c];
+                    g += pixel[1] * weight[c];
+                    red += pixel[2] * weight[c];
+                }
+
+                acc[0] += b * rowWeight;
+                acc[1] += g * rowWeight;
+                acc[2] += red * rowWeight;
+            }
+        }
+
+        uchar* out = cells.ptr<uchar>(y);
+        for (size_t i = 0; i < rowAccumulator.size(); ++i) {
+            out[i] = static_cast<uchar>((rowAccumulator[i] + half) >> shift);
+        }
+    }
+}
+
+void ASCIIConverter::cellsToASCII(const cv::Mat& cellFrame, std::string& out) {
+    if (colorMode != ColorMode::GRAYSCALE) {
+        if (halfBlock) {
+            pixelsToHalfBlocks(cellFrame, out);
+        } else {
+            pixelsToColorASCII(cellFrame, out);
+        }
+        return;
+    }
+
+    // Fixed size output, written in place without any appends
+    out.resize(static_cast<size_t>(cellFrame.cols + 1) * cellFrame.rows);
+    char* dst = &out[0];
+
+    for (int y = 0; y < cellFrame.rows; ++y) {
+        const cv::Vec3b* row = cellFrame.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < cellFrame.cols; ++x) {
+            const cv::Vec3b& pixel = row[x];
+            *dst++ = glyphForLuma[(pixel[2] * 77 + pixel[1] * 150 + pixel[0] * 29) >> 8];
+        }
+        *dst++ = '\n';
+    }
+}
+
+cv::Mat ASCIIConverter::resizeFrame(const cv::Mat& frame) {
+    cv::Mat resized;
+    cv::resize(frame, resized, cv::Size(frameWidth, outputHeight(frame.cols, frame.rows)), 0, 0, cv::INTER_AREA);
+    return resized;
+}
+
+cv::Mat ASCIIConverter::convertToGrayscale(const cv::Mat& frame) {
+    cv::Mat gray;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    return gray;
+}
+
+std::string ASCIIConverter::pixelsToASCII(const cv::Mat& grayFrame) {
+    std::string result;
+    result.reserve((grayFrame.cols + 1) * grayFrame.rows);
+
+    for (int y = 0; y < grayFrame.rows; ++y) {
+        const uchar* row = grayFrame.ptr<uchar>(y);
+        for (int x = 0; x < grayFrame.cols; ++x) {
+            result += ASCII_CHARS[row[x] * (ASCII_CHARS.size() - 1) / 255];
+        }
+        result += '\n';
+    }
+
+    return result;
+}
+
+void ASCIIConverter::setTruecolorBits(int bits) {
+    bits = std::min(std::max(bits, 1), 8);
+    truecolorMask = (0xFF << (8 - bits)) & 0xFF;
+}
+
+int ASCIIConverter::colorKey(const cv::Vec3b& bgr) const {
+    int b = bgr[0], g = bgr[1], r = bgr[2];
+
+    if (colorMode == ColorMode::TRUECOLOR) {
+        return ((r & truecolorMask) << 16) | ((g & truecolorMask) << 8) | (b & truecolorMask);
+    }
+
+    // Near-gray pixels look better on the 24-step gray ramp than in the 6x6x6 cube
+    if (std::abs(r - g) < 10 && std::abs(g - b) < 10) {
+        int gray = (r + g + b) / 3;
+        if (gray < 8) return 16;
+        if (gray > 238) return 231;
+        return 232 + (gray - 8) * 23 / 230;
+    }
+
+    const EscapeTables& tables = escapeTables();
+    return 16 + 36 * tables.cubeLevel[r] + 6 * tables.cubeLevel[g] + tables.cubeLevel[b];
+}
+
+void ASCIIConverter::appendColor(std::string& out, int key, bool background) const {
+    const EscapeTables& tables = escapeTables();
+
+    if (colorMode == ColorMode::ANSI_256) {
+        out += background ? tables.background256[key] : tables.foreground256[key];
+        return;
+    }
+
+    out += background ? "\033[48;2;" : "\033[38;2;";
+    out += tables.decimal[(key >> 16) & 0xFF];
+    out += ';';
+    out += tables.decimal[(key >> 8) & 0xFF];
+    out += ';';
+    out += tables.decimal[key & 0xFF];
+    out += 'm';
+}
+
+void ASCIIConverter::pixelsToColorASCII(const cv::Mat& colorFrame, std::string& out) {
+    out.clear();
+    out.reserve((colorFrame.cols * 4 + 1) * colorFrame.rows);
+
+    for (int y = 0; y < colorFrame.rows; ++y) {
+        const cv::Vec3b* row = colorFrame.ptr<cv::Vec3b>(y);
+        // Every row starts without color state so rows can be redrawn on their own
+        int lastKey = -1;
+
+        for (int x = 0; x < colorFrame.cols; ++x) {
+            const cv::Vec3b& pixel = row[x];
+            char glyph = glyphForLuma[(pixel[2] * 77 + pixel[1] * 150 + pixel[0] * 29) >> 8];
+
+            // A space has no foreground, so its color never needs to be sent
+            if (glyph != ' ') {
+                int key = colorKey(pixel);
+                if (key != lastKey) {
+                    appendColor(out, key, false);
+                    lastKey = key;
+                }
+            }
+            out += glyph;
+        }
+        out += '\n';
+    }
+}
+
+void ASCIIConverter::pixelsToHalfBlocks(const cv::Mat& colorFrame, std::string& out) {
+    out.clear();
+    out.reserve((colorFrame.cols * 8 + 1) * (colorFrame.rows / 2 + 1));
+
+    for (int y = 0; y + 1 < colorFrame.rows; y += 2) {
+        const cv::Vec3b* top = colorFrame.ptr<cv::Vec3b>(y);
+        const cv::Vec3b* bottom = colorFrame.ptr<cv::Vec3b>(y + 1);
+        int lastForeground = -1;
+        int lastBackground = -1;
+
+        for (int x = 0; x < colorFrame.cols; ++x) {
+            int foreground = colorKey(top[x]);
+            int background = colorKey(bottom[x]);
+
+            if (background != lastBackground) {
+                appendColor(out, background, true);
+                lastBackground = background;
+            }
+
+            // Same color on both halves: a space only needs the background
+            if (foreground == background) {
+                out += ' ';
+                continue;
+            }
+
+            if (foreground != lastForeground) {
+                appendColor(out, foreground, false);
+                lastForeground = foreground;
+            }
+            out += HALF_BLOCK;
+        }
+        // A background left set would fill the rest of the line and, with
+        // background color erase, any later screen clear
+        out += "\033[0m\n";
+    }
+}
+
+void ASCIIConverter::showProgress(int current, int total) {
+    int percent = total > 0 ? current * 100 / total : 0;
+    std::cout << "\rProgress: " << current << "/" << total << " (" << percent << "%)" << std::flush;
+}
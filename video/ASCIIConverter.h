@@ -1,20 +1,91 @@
 #pragma once
 
 #include <opencv2/opencv.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
+
+enum class ColorMode {
+    GRAYSCALE,
+    ANSI_256,
+    TRUECOLOR
+};
+
+// Accumulated time per conversion stage, only collected when enabled
+struct ConversionTimings {
+    double resizeSeconds = 0.0;
+    double quantizeSeconds = 0.0;
+};
 
 class ASCIIConverter {
 public:
-    ASCIIConverter(int frameWidth = 150);
+    // halfBlock renders two pixel rows per cell with the upper half block
+    // glyph, fg = top pixel and bg = bottom pixel. Ignored in GRAYSCALE.
+    ASCIIConverter(int frameWidth = 150, ColorMode colorMode = ColorMode::GRAYSCALE, bool halfBlock = false);
+    
+    // Single pass: area-averages the BGR frame straight into cells and writes
+    // glyphs into a buffer that is reused between calls.
+    const std::string& convertFrameToASCII(const cv::Mat& frame);
+    
+    // resize -> grayscale -> glyphs through OpenCV, kept as a reference for benchmarks
+    std::string convertFrameToASCIIMultiPass(const cv::Mat& frame);
+    
+    void showProgress(int current, int total);
     
-    std::string convertFrameToASCII(const cv::Mat& frame);
+    // Sampling tables follow automatically on the next frame
+    void setFrameWidth(int width) { frameWidth = width; }
+    int getFrameWidth() const { return frameWidth; }
+    
+    // TRUECOLOR keeps all 8 bits per channel by default, so only identical
+    // colors share an escape. Fewer bits trade color accuracy for output
+    // size: neighbouring cells with near-identical colors then merge.
+    void setTruecolorBits(int bits);
+    
+    void enableTimings(bool enabled) { timingEnabled = enabled; }
+    const ConversionTimings& getTimings() const { return timings; }
     
 private:
+    // Area-averaging taps for one axis: output cell i reads count[i] source
+    // pixels starting at start[i], weighted by weights[offset[i] + k].
+    // Weights are fixed point and sum to 1 << WEIGHT_BITS per cell.
+    struct SamplingAxis {
+        std::vector<int> start;
+        std::vector<int> count;
+        std::vector<int> offset;
+        std::vector<uint32_t> weights;
+    };
+    
     static const std::string ASCII_CHARS;
+    static const int WEIGHT_BITS = 12;
     int frameWidth;
+    ColorMode colorMode;
+    bool halfBlock;
+    int truecolorMask;
+    bool timingEnabled;
+    ConversionTimings timings;
+    
+    char glyphForLuma[256];
+    SamplingAxis columns;
+    SamplingAxis rows;
+    int sampledCols;
+    int sampledRows;
+    int sampledWidth;
+    std::vector<uint32_t> rowAccumulator;
+    cv::Mat cells;
+    cv::Mat bgrScratch;
+    std::string output;
+    
+    int outputHeight(int srcCols, int srcRows) const;
+    void rebuildSamplingTables(int srcCols, int srcRows);
+    void buildAxis(int srcSize, int dstSize, SamplingAxis& axis);
+    void sampleCells(const cv::Mat& frame);
+    void cellsToASCII(const cv::Mat& cellFrame, std::string& out);
     
     cv::Mat resizeFrame(const cv::Mat& frame);
     cv::Mat convertToGrayscale(const cv::Mat& frame);
     std::string pixelsToASCII(const cv::Mat& grayFrame);
-    void showProgress(int current, int total);
-};
\ No newline at end of file
+    void pixelsToColorASCII(const cv::Mat& colorFrame, std::string& out);
+    void pixelsToHalfBlocks(const cv::Mat& colorFrame, std::string& out);
+    int colorKey(const cv::Vec3b& bgr) const;
+    void appendColor(std::string& out, int key, bool background) const;
+};
@@ -2,80 +2,101 @@
 #include "ASCIIConverter.h"
 #include "AudioPlayer.h"
 #include "FrameTimer.h"
+#include "Terminal.h"
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <conio.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
 #else
 #include <termios.h>
 #include <unistd.h>
 #endif
 
-ASCIIVideoPlayer::ASCIIVideoPlayer() : totalFrames(0), frameRate(30.75) {
-    audioPath = "audio.wav";
-}
+ASCIIVideoPlayer::ASCIIVideoPlayer() : hasAudio(false), totalFrames(0), frameRate(30.75),
+      videoWidth(0), videoHeight(0), colorMode(ColorMode::GRAYSCALE), halfBlock(false),
+      qualityScale(1.0), frameCostAverage(0.0), framesSinceAdjust(0) {}
 
 ASCIIVideoPlayer::~ASCIIVideoPlayer() {
     restoreConsole();
 }
 
+void ASCIIVideoPlayer::setColorMode(ColorMode mode, bool halfBlock) {
+    colorMode = mode;
+    this->halfBlock = halfBlock;
+}
+
 bool ASCIIVideoPlayer::loadVideo(const std::string& videoPath) {
-    cv::VideoCapture cap(videoPath);
-    if (!cap.isOpened()) {
+    capture.open(videoPath);
+    if (!capture.isOpened()) {
         std::cerr << "Error: Could not open video file " << videoPath << std::endl;
         return false;
     }
     
-    totalFrames = static_cast<int>(cap.get(cv::CAP_PROP_FRAME_COUNT));
-    frameRate = cap.get(cv::CAP_PROP_FPS);
-    
-    std::cout << "Extracting audio..." << std::endl;
-    extractAudio(videoPath);
+    totalFrames = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_COUNT));
+    frameRate = capture.get(cv::CAP_PROP_FPS);
+    videoWidth = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH));
+    videoHeight = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT));
     
-    std::cout << "Generating ASCII frames..." << std::endl;
-    generateASCIIFrames(videoPath);
+    // Audio decodes in the background and is buffered until playback starts
+    std::cout << "Starting audio stream..." << std::endl;
+    hasAudio = audioPlayer.loadAudio(videoPath);
+    if (!hasAudio) {
+        std::cerr << "Warning: Playing without audio" << std::endl;
+    }
     
-    cap.release();
     return true;
 }
 
-void ASCIIVideoPlayer::extractAudio(const std::string& videoPath) {
-    std::string command = "ffmpeg -i \"" + videoPath + "\" -vn -acodec pcm_s16le -ar 44100 -ac 2 \"" + audioPath + "\" -y";
+int ASCIIVideoPlayer::fitFrameWidth(const TerminalSize& terminal) const {
+    int width = terminal.columns;
     
-    #ifdef _WIN32
-    system(command.c_str());
-    #else
-    system(command.c_str());
-    #endif
+    // Cells are about twice as tall as wide; keep the last row free so the
+    // frame never scrolls the terminal
+    if (videoWidth > 0 && videoHeight > 0) {
+        int widthForRows = static_cast<int>((terminal.rows - 1) * 2.0 * videoWidth / videoHeight);
+        width = std::min(width, widthForRows);
+    }
+    width = std::max(width, 1);
+    
+    // MIN_FRAME_WIDTH only limits how far throughput scaling shrinks the
+    // frame; it never overrides what fits in the terminal
+    int scaled = std::max(static_cast<int>(width * qualityScale), MIN_FRAME_WIDTH);
+    return std::min(scaled, width);
 }
 
-void ASCIIVideoPlayer::generateASCIIFrames(const std::string& videoPath) {
-    cv::VideoCapture cap(videoPath);
-    ASCIIConverter converter(150);
+void ASCIIVideoPlayer::applyFrameWidth(ASCIIConverter& converter, const TerminalSize& terminal) {
+    int width = fitFrameWidth(terminal);
+    if (width == converter.getFrameWidth()) return;
     
-    cv::Mat frame;
-    int frameCount = 0;
+    converter.setFrameWidth(width);
+    std::cout << "\033[2J"; // Old frame may be wider or taller than the new one
+}
+
+void ASCIIVideoPlayer::adaptQuality(double frameSeconds, double frameBudget, ASCIIConverter& converter, const TerminalSize& terminal) {
+    frameCostAverage = frameCostAverage * 0.9 + frameSeconds * 0.1;
     
-    asciiFrames.clear();
-    asciiFrames.reserve(totalFrames);
+    if (++framesSinceAdjust < ADJUST_INTERVAL) return;
     
-    while (cap.read(frame) && frameCount < totalFrames) {
-        std::string asciiFrame = converter.convertFrameToASCII(frame);
-        asciiFrames.push_back(asciiFrame);
-        
-        frameCount++;
-        
-        if (frameCount % 10 == 0) {
-            converter.showProgress(frameCount, totalFrames);
-        }
+    // Converting and writing a frame has to fit in its slot with some room
+    // left over; otherwise shrink, and grow back slowly once there is headroom
+    if (frameCostAverage > frameBudget * 0.9 && fitFrameWidth(terminal) > MIN_FRAME_WIDTH) {
+        qualityScale *= 0.8;
+    } else if (frameCostAverage < frameBudget * 0.5 && qualityScale < 1.0) {
+        qualityScale = std::min(1.0, qualityScale * 1.1);
+    } else {
+        return;
     }
     
-    std::cout << std::endl << "ASCII generation completed!" << std::endl;
-    cap.release();
+    framesSinceAdjust = 0;
+    applyFrameWidth(converter, terminal);
 }
 
 void ASCIIVideoPlayer::setupConsole() {
@@ -83,7 +104,11 @@ void ASCIIVideoPlayer::setupConsole() {
     HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
     SetConsoleTextAttribute(hConsole, FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
     
-    system("mode 150,50");
+    // Color modes need VT escape handling and UTF-8 for the half block glyph
+    DWORD consoleMode = 0;
+    GetConsoleMode(hConsole, &consoleMode);
+    SetConsoleMode(hConsole, consoleMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    SetConsoleOutputCP(CP_UTF8);
     
     CONSOLE_CURSOR_INFO cursorInfo;
     GetConsoleCursorInfo(hConsole, &cursorInfo);
@@ -114,29 +139,64 @@ void ASCIIVideoPlayer::restoreConsole() {
 
 // function made bhy AI
 void ASCIIVideoPlayer::playVideo() {
-    if (asciiFrames.empty()) {
-        std::cerr << "No ASCII frames loaded!" << std::endl;
+    if (!capture.isOpened()) {
+        std::cerr << "No video loaded!" << std::endl;
         return;
     }
     
     setupConsole();
+    Terminal::watchResize();
     
-    AudioPlayer audioPlayer;
-    if (!audioPlayer.initialize()) {
-        std::cerr << "Failed to initialize audio player!" << std::endl;
-        return;
-    }
+    TerminalSize terminal = Terminal::querySize();
+    qualityScale = 1.0;
+    frameCostAverage = 0.0;
+    framesSinceAdjust = 0;
+    ASCIIConverter converter(fitFrameWidth(terminal), colorMode, halfBlock);
     
-    if (!audioPlayer.loadAudio(audioPath)) {
-        std::cerr << "Failed to load audio file!" << std::endl;
-        return;
+    if (hasAudio) {
+        if (audioPlayer.initialize()) {
+            audioPlayer.playAudio();
+        } else {
+            std::cerr << "Failed to initialize audio player!" << std::endl;
+        }
     }
     
-    audioPlayer.playAudio();
-    
     FrameTimer timer(frameRate);
+    timer.start();
+    
+    cv::Mat frame;
+    long long frameIndex = 0;
+    int droppedFrames = 0;
     
-    for (size_t i = 0; i < asciiFrames.size(); ++i) {
+    while (true) {
+        // Frames we are already too late for are skipped without being
+        // converted or written, which lowers the effective frame rate
+        long long due = timer.currentFrame();
+        bool ended = false;
+        while (frameIndex < due) {
+            if (!capture.grab()) {
+                ended = true;
+                break;
+            }
+            ++frameIndex;
+            ++droppedFrames;
+        }
+        if (ended || !capture.read(frame)) break;
+        
+        auto frameStart = std::chrono::steady_clock::now();
+        
+        #ifdef _WIN32
+        bool resized = frameIndex % ADJUST_INTERVAL == 0;
+        #else
+        bool resized = Terminal::consumeResize();
+        #endif
+        if (resized) {
+            terminal = Terminal::querySize();
+            applyFrameWidth(converter, terminal);
+        }
+        
+        const std::string& asciiFrame = converter.convertFrameToASCII(frame);
+        
         #ifdef _WIN32
         COORD coord = {0, 0};
         SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
@@ -144,8 +204,13 @@ void ASCIIVideoPlayer::playVideo() {
         std::cout << "\033[1;1H"; // Move cursor to top-left
         #endif
         
-        std::cout << asciiFrames[i] << std::flush;
-        timer.sleep();
+        std::cout << asciiFrame << std::flush;
+        
+        std::chrono::duration<double> frameSeconds = std::chrono::steady_clock::now() - frameStart;
+        adaptQuality(frameSeconds.count(), timer.getFrameBudget(), converter, terminal);
+        
+        ++frameIndex;
+        timer.sleepUntil(frameIndex);
         
         #ifdef _WIN32
         if (_kbhit()) {
@@ -158,7 +223,12 @@ void ASCIIVideoPlayer::playVideo() {
     }
     
     audioPlayer.stopAudio();
+    hasAudio = false;
+    capture.release();
     restoreConsole();
+    
+    std::cout << std::endl << "Playback finished (" << droppedFrames << " frames dropped, final width "
+              << converter.getFrameWidth() << ")" << std::endl;
 }
 
 void ASCIIVideoPlayer::showMenu() {
@@ -181,6 +251,20 @@ void ASCIIVideoPlayer::showMenu() {
             std::string videoPath;
             std::getline(std::cin, videoPath);
             
+            std::cout << "Color mode (1) grayscale (2) 256-color (3) truecolor (4) truecolor half-block: ";
+            std::string modeInput;
+            std::getline(std::cin, modeInput);
+            
+            if (modeInput == "2") {
+                setColorMode(ColorMode::ANSI_256);
+            } else if (modeInput == "3") {
+                setColorMode(ColorMode::TRUECOLOR);
+            } else if (modeInput == "4") {
+                setColorMode(ColorMode::TRUECOLOR, true);
+            } else {
+                setColorMode(ColorMode::GRAYSCALE);
+            }
+            
             if (loadVideo(videoPath)) {
                 playVideo();
             } else {
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "ASCIIConverter.h"
+#include "AudioPlayer.h"
+#include "Terminal.h"
+#include <opencv2/opencv.hpp>
 #include <string>
-#include <vector>
 
 class ASCIIVideoPlayer {
 public:
@@ -11,15 +14,31 @@ public:
     bool loadVideo(const std::string& videoPath);
     void playVideo();
     void showMenu();
+    void setColorMode(ColorMode mode, bool halfBlock = false);
     
 private:
-    std::vector<std::string> asciiFrames;
-    std::string audioPath;
+    // constexpr so passing them to std::max by reference needs no out-of-class definition
+    static constexpr int MIN_FRAME_WIDTH = 40;
+    static constexpr int ADJUST_INTERVAL = 15;
+    
+    cv::VideoCapture capture;
+    AudioPlayer audioPlayer;
+    bool hasAudio;
     int totalFrames;
     double frameRate;
+    int videoWidth;
+    int videoHeight;
+    ColorMode colorMode;
+    bool halfBlock;
+    
+    // Fraction of the terminal-fitted width currently rendered
+    double qualityScale;
+    double frameCostAverage;
+    int framesSinceAdjust;
     
-    void extractAudio(const std::string& videoPath);
-    void generateASCIIFrames(const std::string& videoPath);
+    int fitFrameWidth(const TerminalSize& terminal) const;
+    void adaptQuality(double frameSeconds, double frameBudget, ASCIIConverter& converter, const TerminalSize& terminal);
+    void applyFrameWidth(ASCIIConverter& converter, const TerminalSize& terminal);
     void setupConsole();
     void restoreConsole();
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "AudioBuffer.h"
+#include <algorithm>
+
+AudioBuffer::AudioBuffer(size_t capacitySamples)
+    : ring(capacitySamples), readPos(0), size(0), closed(false) {}
+
+bool AudioBuffer::push(const int16_t* samples, size_t count) {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (count > 0) {
+        notFull.wait(lock, [this]() { return closed || size < ring.size(); });
+        if (closed) return false;
+
+        size_t writePos = (readPos + size) % ring.size();
+        size_t chunk = std::min(count, ring.size() - size);
+        chunk = std::min(chunk, ring.size() - writePos);
+
+        std::copy(samples, samples + chunk, ring.begin() + writePos);
+        size += chunk;
+        samples += chunk;
+        count -= chunk;
+
+        notEmpty.notify_one();
+    }
+
+    return true;
+}
+
+size_t AudioBuffer::pop(int16_t* samples, size_t maxCount) {
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this]() { return closed || size > 0; });
+
+    size_t total = 0;
+    while (total < maxCount && size > 0) {
+        size_t chunk = std::min(maxCount - total, size);
+        chunk = std::min(chunk, ring.size() - readPos);
+
+        std::copy(ring.begin() + readPos, ring.begin() + readPos + chunk, samples + total);
+        readPos = (readPos + chunk) % ring.size();
+        size -= chunk;
+        total += chunk;
+    }
+
+    notFull.notify_one();
+    return total;
+}
+
+void AudioBuffer::close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    notEmpty.notify_all();
+    notFull.notify_all();
+}
+
+void AudioBuffer::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    readPos = 0;
+    size = 0;
+    closed = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Bounded ring buffer of interleaved 16-bit samples shared between the
+// decoder thread (producer) and the playback thread (consumer). A full
+// buffer blocks the decoder, so memory stays fixed no matter how long
+// the video is.
+class AudioBuffer {
+public:
+    AudioBuffer(size_t capacitySamples);
+
+    // Blocks until all samples are queued. Returns false if the buffer was closed.
+    bool push(const int16_t* samples, size_t count);
+
+    // Blocks until at least one sample is available. Returns 0 once the
+    // buffer is closed and fully drained.
+    size_t pop(int16_t* samples, size_t maxCount);
+
+    // Marks end of stream and wakes up both sides.
+    void close();
+    void reset();
+
+private:
+    std::vector<int16_t> ring;
+    size_t readPos;
+    size_t size;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+};
@@ -0,0 +1,143 @@
+#include "AudioDecoder.h"
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswresample/swresample.h>
+#include <libavutil/channel_layout.h>
+}
+
+AudioDecoder::AudioDecoder()
+    : formatContext(nullptr), codecContext(nullptr), resampler(nullptr), streamIndex(-1), running(false) {}
+
+AudioDecoder::~AudioDecoder() {
+    stop();
+    close();
+}
+
+bool AudioDecoder::open(const std::string& mediaPath) {
+    close();
+
+    if (avformat_open_input(&formatContext, mediaPath.c_str(), nullptr, nullptr) < 0) {
+        std::cerr << "Error: Could not open media file " << mediaPath << std::endl;
+        return false;
+    }
+
+    if (avformat_find_stream_info(formatContext, nullptr) < 0) {
+        std::cerr << "Error: Could not read stream info" << std::endl;
+        close();
+        return false;
+    }
+
+    const AVCodec* codec = nullptr;
+    streamIndex = av_find_best_stream(formatContext, AVMEDIA_TYPE_AUDIO, -1, -1, &codec, 0);
+    if (streamIndex < 0 || !codec) {
+        std::cerr << "Error: No audio stream found" << std::endl;
+        close();
+        return false;
+    }
+
+    // Let the demuxer skip video packets instead of handing them to us
+    for (unsigned int i = 0; i < formatContext->nb_streams; ++i) {
+        if (static_cast<int>(i) != streamIndex) {
+            formatContext->streams[i]->discard = AVDISCARD_ALL;
+        }
+    }
+
+    codecContext = avcodec_alloc_context3(codec);
+    if (!codecContext ||
+        avcodec_parameters_to_context(codecContext, formatContext->streams[streamIndex]->codecpar) < 0 ||
+        avcodec_open2(codecContext, codec, nullptr) < 0) {
+        std::cerr << "Error: Could not open audio decoder" << std::endl;
+        close();
+        return false;
+    }
+
+    AVChannelLayout outLayout;
+    av_channel_layout_default(&outLayout, CHANNELS);
+
+    if (swr_alloc_set_opts2(&resampler,
+                            &outLayout, AV_SAMPLE_FMT_S16, SAMPLE_RATE,
+                            &codecContext->ch_layout, codecContext->sample_fmt, codecContext->sample_rate,
+                            0, nullptr) < 0 ||
+        swr_init(resampler) < 0) {
+        std::cerr << "Error: Could not initialize audio resampler" << std::endl;
+        av_channel_layout_uninit(&outLayout);
+        close();
+        return false;
+    }
+
+    av_channel_layout_uninit(&outLayout);
+    return true;
+}
+
+void AudioDecoder::start(AudioBuffer& buffer) {
+    if (running || !codecContext) return;
+
+    running = true;
+    decodeThread = std::thread(&AudioDecoder::decodeLoop, this, &buffer);
+}
+
+void AudioDecoder::stop() {
+    running = false;
+
+    if (decodeThread.joinable()) {
+        decodeThread.join();
+    }
+}
+
+void AudioDecoder::decodeLoop(AudioBuffer* buffer) {
+    AVPacket* packet = av_packet_alloc();
+    AVFrame* frame = av_frame_alloc();
+    std::vector<int16_t> converted;
+
+    auto drainDecoder = [&]() {
+        while (running && avcodec_receive_frame(codecContext, frame) >= 0) {
+            int maxOut = swr_get_out_samples(resampler, frame->nb_samples);
+            converted.resize(static_cast<size_t>(maxOut) * CHANNELS);
+            uint8_t* out = reinterpret_cast<uint8_t*>(converted.data());
+
+            int got = swr_convert(resampler, &out, maxOut,
+                                  const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+            if (got > 0 && !buffer->push(converted.data(), static_cast<size_t>(got) * CHANNELS)) {
+                running = false;
+            }
+        }
+    };
+
+    while (running && av_read_frame(formatContext, packet) >= 0) {
+        if (packet->stream_index == streamIndex && avcodec_send_packet(codecContext, packet) >= 0) {
+            drainDecoder();
+        }
+        av_packet_unref(packet);
+    }
+
+    if (running) {
+        avcodec_send_packet(codecContext, nullptr);
+        drainDecoder();
+
+        // Flush whatever the resampler is still holding on to
+        int maxOut = swr_get_out_samples(resampler, 0);
+        if (maxOut > 0) {
+            converted.resize(static_cast<size_t>(maxOut) * CHANNELS);
+            uint8_t* out = reinterpret_cast<uint8_t*>(converted.data());
+            int got = swr_convert(resampler, &out, maxOut, nullptr, 0);
+            if (got > 0) {
+                buffer->push(converted.data(), static_cast<size_t>(got) * CHANNELS);
+            }
+        }
+    }
+
+    buffer->close();
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+}
+
+void AudioDecoder::close() {
+    swr_free(&resampler);
+    avcodec_free_context(&codecContext);
+    avformat_close_input(&formatContext);
+    streamIndex = -1;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "AudioBuffer.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct SwrContext;
+
+// Decodes the audio track of a media file in-process (libavformat/libavcodec)
+// and streams 44.1 kHz stereo S16 samples into an AudioBuffer on a background
+// thread. Nothing is written to disk.
+//
+// Needs FFmpeg 5.1 or newer (swr_alloc_set_opts2 and AVChannelLayout) and
+// links libavformat, libavcodec, libswresample and libavutil.
+class AudioDecoder {
+public:
+    static const int SAMPLE_RATE = 44100;
+    static const int CHANNELS = 2;
+
+    AudioDecoder();
+    ~AudioDecoder();
+
+    bool open(const std::string& mediaPath);
+    void start(AudioBuffer& buffer);
+    void stop();
+
+private:
+    AVFormatContext* formatContext;
+    AVCodecContext* codecContext;
+    SwrContext* resampler;
+    int streamIndex;
+    std::thread decodeThread;
+    std::atomic<bool> running;
+
+    void decodeLoop(AudioBuffer* buffer);
+    void close();
+};
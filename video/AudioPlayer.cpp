@@ -0,0 +1,83 @@
+#include "AudioPlayer.h"
+#include <iostream>
+#include <vector>
+
+AudioPlayer::AudioPlayer() : AudioPlayer(std::unique_ptr<AudioSink>(new DeviceAudioSink())) {}
+
+AudioPlayer::AudioPlayer(std::unique_ptr<AudioSink> sink)
+    : sink(std::move(sink)),
+      buffer(BUFFER_SECONDS * AudioDecoder::SAMPLE_RATE * AudioDecoder::CHANNELS),
+      playing(false),
+      framesPlayed(0),
+      sinkOpen(false) {}
+
+AudioPlayer::~AudioPlayer() {
+    stopAudio();
+}
+
+bool AudioPlayer::initialize() {
+    if (sinkOpen) return true;
+
+    sinkOpen = sink->open(AudioDecoder::SAMPLE_RATE, AudioDecoder::CHANNELS);
+    return sinkOpen;
+}
+
+bool AudioPlayer::loadAudio(const std::string& mediaPath) {
+    stopAudio();
+    buffer.reset();
+
+    if (!decoder.open(mediaPath)) {
+        return false;
+    }
+
+    decoder.start(buffer);
+    return true;
+}
+
+void AudioPlayer::playAudio() {
+    if (playing || !sinkOpen) return;
+
+    playing = true;
+    framesPlayed = 0;
+    playbackThread = std::thread(&AudioPlayer::playbackLoop, this);
+}
+
+void AudioPlayer::stopAudio() {
+    playing = false;
+
+    // Unblocks both the decoder (buffer full) and playback (buffer empty)
+    buffer.close();
+    decoder.stop();
+
+    if (playbackThread.joinable()) {
+        playbackThread.join();
+    }
+
+    if (sinkOpen) {
+        sink->close();
+        sinkOpen = false;
+    }
+}
+
+void AudioPlayer::waitUntilFinished() {
+    // Playback ends by itself once the decoder has closed and drained the buffer
+    if (playbackThread.joinable()) {
+        playbackThread.join();
+    }
+    playing = false;
+}
+
+void AudioPlayer::playbackLoop() {
+    std::vector<int16_t> chunk(CHUNK_FRAMES * AudioDecoder::CHANNELS);
+
+    while (playing) {
+        size_t samples = buffer.pop(chunk.data(), chunk.size());
+        if (samples == 0) break;
+
+        if (!sink->write(chunk.data(), samples / AudioDecoder::CHANNELS)) {
+            std::cerr << "Error: Audio output failed" << std::endl;
+            break;
+        }
+        framesPlayed += samples / AudioDecoder::CHANNELS;
+    }
+}
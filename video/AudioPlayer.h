@@ -0,0 +1,43 @@
+#pragma once
+
+#include "AudioBuffer.h"
+#include "AudioDecoder.h"
+#include "AudioSink.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Streams a media file's audio track to a sink. Decoding starts as soon as
+// loadAudio() is called and fills a bounded buffer while the video frames
+// are being prepared; playAudio() then drains that buffer into the sink.
+class AudioPlayer {
+public:
+    AudioPlayer();
+    AudioPlayer(std::unique_ptr<AudioSink> sink);
+    ~AudioPlayer();
+
+    bool initialize();
+    bool loadAudio(const std::string& mediaPath);
+    void playAudio();
+    void stopAudio();
+
+    // Blocks until everything decoded has been written to the sink. Without
+    // a device the sink never blocks, so this runs faster than real time.
+    void waitUntilFinished();
+    size_t getFramesPlayed() const { return framesPlayed; }
+
+private:
+    static const size_t BUFFER_SECONDS = 2;
+    static const size_t CHUNK_FRAMES = 1024;
+
+    std::unique_ptr<AudioSink> sink;
+    AudioDecoder decoder;
+    AudioBuffer buffer;
+    std::thread playbackThread;
+    std::atomic<bool> playing;
+    std::atomic<size_t> framesPlayed;
+    bool sinkOpen;
+
+    void playbackLoop();
+};
@@ -0,0 +1,206 @@
+#include "AudioSink.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+
+#ifndef _WIN32
+#include <alsa/asoundlib.h>
+#endif
+
+bool NullAudioSink::open(int /*sampleRate*/, int /*channels*/) {
+    return true;
+}
+
+bool NullAudioSink::write(const int16_t* /*samples*/, size_t /*frameCount*/) {
+    return true;
+}
+
+void NullAudioSink::close() {}
+
+WavFileAudioSink::WavFileAudioSink(const std::string& path) : path(path), channels(0), dataBytes(0) {}
+
+WavFileAudioSink::~WavFileAudioSink() {
+    close();
+}
+
+static void writeLE(std::ofstream& out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+bool WavFileAudioSink::open(int sampleRate, int channels) {
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    this->channels = channels;
+    dataBytes = 0;
+    writeHeader(sampleRate);
+    return true;
+}
+
+void WavFileAudioSink::writeHeader(int sampleRate) {
+    file.write("RIFF", 4);
+    writeLE(file, 36 + dataBytes, 4);
+    file.write("WAVE", 4);
+    file.write("fmt ", 4);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2); // PCM
+    writeLE(file, channels, 2);
+    writeLE(file, sampleRate, 4);
+    writeLE(file, sampleRate * channels * 2, 4);
+    writeLE(file, channels * 2, 2);
+    writeLE(file, 16, 2);
+    file.write("data", 4);
+    writeLE(file, dataBytes, 4);
+}
+
+bool WavFileAudioSink::write(const int16_t* samples, size_t frameCount) {
+    size_t bytes = frameCount * channels * sizeof(int16_t);
+    file.write(reinterpret_cast<const char*>(samples), bytes);
+    dataBytes += static_cast<uint32_t>(bytes);
+    return file.good();
+}
+
+void WavFileAudioSink::close() {
+    if (!file.is_open()) return;
+
+    // Sizes are only known now, patch them into the header
+    file.seekp(4);
+    writeLE(file, 36 + dataBytes, 4);
+    file.seekp(40);
+    writeLE(file, dataBytes, 4);
+    file.close();
+}
+
+#ifdef _WIN32
+
+DeviceAudioSink::DeviceAudioSink() : channels(0), device(nullptr), nextBlock(0) {}
+
+DeviceAudioSink::~DeviceAudioSink() {
+    close();
+}
+
+bool DeviceAudioSink::open(int sampleRate, int channels) {
+    this->channels = channels;
+
+    WAVEFORMATEX format = {};
+    format.wFormatTag = WAVE_FORMAT_PCM;
+    format.nChannels = static_cast<WORD>(channels);
+    format.nSamplesPerSec = sampleRate;
+    format.wBitsPerSample = 16;
+    format.nBlockAlign = static_cast<WORD>(channels * 2);
+    format.nAvgBytesPerSec = sampleRate * format.nBlockAlign;
+
+    if (waveOutOpen(&device, WAVE_MAPPER, &format, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) {
+        std::cerr << "Error: Could not open audio device" << std::endl;
+        device = nullptr;
+        return false;
+    }
+
+    for (int i = 0; i < BUFFER_COUNT; ++i) {
+        headers[i] = {};
+        headers[i].dwFlags = WHDR_DONE;
+    }
+    nextBlock = 0;
+    return true;
+}
+
+bool DeviceAudioSink::write(const int16_t* samples, size_t frameCount) {
+    if (!device) return false;
+
+    WAVEHDR& header = headers[nextBlock];
+    while (!(header.dwFlags & WHDR_DONE)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header.dwFlags & WHDR_PREPARED) {
+        waveOutUnprepareHeader(device, &header, sizeof(WAVEHDR));
+    }
+
+    std::vector<int16_t>& block = blocks[nextBlock];
+    block.assign(samples, samples + frameCount * channels);
+
+    header = {};
+    header.lpData = reinterpret_cast<LPSTR>(block.data());
+    header.dwBufferLength = static_cast<DWORD>(block.size() * sizeof(int16_t));
+    waveOutPrepareHeader(device, &header, sizeof(WAVEHDR));
+    waveOutWrite(device, &header, sizeof(WAVEHDR));
+
+    nextBlock = (nextBlock + 1) % BUFFER_COUNT;
+    return true;
+}
+
+void DeviceAudioSink::close() {
+    if (!device) return;
+
+    waveOutReset(device);
+    for (int i = 0; i < BUFFER_COUNT; ++i) {
+        if (headers[i].dwFlags & WHDR_PREPARED) {
+            waveOutUnprepareHeader(device, &headers[i], sizeof(WAVEHDR));
+        }
+    }
+    waveOutClose(device);
+    device = nullptr;
+}
+
+#else
+
+DeviceAudioSink::DeviceAudioSink() : channels(0), device(nullptr) {}
+
+DeviceAudioSink::~DeviceAudioSink() {
+    close();
+}
+
+bool DeviceAudioSink::open(int sampleRate, int channels) {
+    this->channels = channels;
+
+    snd_pcm_t* pcm = nullptr;
+    if (snd_pcm_open(&pcm, "default", SND_PCM_STREAM_PLAYBACK, 0) < 0) {
+        std::cerr << "Error: Could not open audio device" << std::endl;
+        return false;
+    }
+
+    // 100 ms of device latency, resampling allowed
+    if (snd_pcm_set_params(pcm, SND_PCM_FORMAT_S16_LE, SND_PCM_ACCESS_RW_INTERLEAVED,
+                           channels, sampleRate, 1, 100000) < 0) {
+        std::cerr << "Error: Could not configure audio device" << std::endl;
+        snd_pcm_close(pcm);
+        return false;
+    }
+
+    device = pcm;
+    return true;
+}
+
+bool DeviceAudioSink::write(const int16_t* samples, size_t frameCount) {
+    snd_pcm_t* pcm = static_cast<snd_pcm_t*>(device);
+    if (!pcm) return false;
+
+    while (frameCount > 0) {
+        snd_pcm_sframes_t written = snd_pcm_writei(pcm, samples, frameCount);
+        if (written < 0) {
+            if (snd_pcm_recover(pcm, static_cast<int>(written), 1) < 0) {
+                return false;
+            }
+            continue;
+        }
+        samples += written * channels;
+        frameCount -= written;
+    }
+
+    return true;
+}
+
+void DeviceAudioSink::close() {
+    snd_pcm_t* pcm = static_cast<snd_pcm_t*>(device);
+    if (!pcm) return;
+
+    snd_pcm_drop(pcm);
+    snd_pcm_close(pcm);
+    device = nullptr;
+}
+
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+// Destination for decoded interleaved S16 audio.
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    virtual bool open(int sampleRate, int channels) = 0;
+    virtual bool write(const int16_t* samples, size_t frameCount) = 0;
+    virtual void close() = 0;
+};
+
+// Discards everything; useful for running the player headless.
+class NullAudioSink : public AudioSink {
+public:
+    bool open(int sampleRate, int channels) override;
+    bool write(const int16_t* samples, size_t frameCount) override;
+    void close() override;
+};
+
+// Writes a 16-bit PCM WAV file, mostly for checking decoder output.
+class WavFileAudioSink : public AudioSink {
+public:
+    WavFileAudioSink(const std::string& path);
+    ~WavFileAudioSink() override;
+
+    bool open(int sampleRate, int channels) override;
+    bool write(const int16_t* samples, size_t frameCount) override;
+    void close() override;
+
+private:
+    std::string path;
+    std::ofstream file;
+    int channels;
+    uint32_t dataBytes;
+
+    void writeHeader(int sampleRate);
+};
+
+// Plays through the default output device (waveOut on Windows, ALSA elsewhere).
+// Links against winmm on Windows and libasound elsewhere.
+class DeviceAudioSink : public AudioSink {
+public:
+    DeviceAudioSink();
+    ~DeviceAudioSink() override;
+
+    bool open(int sampleRate, int channels) override;
+    bool write(const int16_t* samples, size_t frameCount) override;
+    void close() override;
+
+private:
+    int channels;
+
+    #ifdef _WIN32
+    static const int BUFFER_COUNT = 4;
+    HWAVEOUT device;
+    WAVEHDR headers[BUFFER_COUNT];
+    std::vector<int16_t> blocks[BUFFER_COUNT];
+    int nextBlock;
+    #else
+    void* device;
+    #endif
+};
@@ -0,0 +1,167 @@
+#include "ConverterBenchmark.h"
+#include "ASCIIConverter.h"
+#include "AudioPlayer.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+cv::Mat makeSyntheticFrame(int index, int width, int height) {
+    cv::Mat frame(height, width, CV_8UC3);
+    for (int y = 0; y < height; ++y) {
+        cv::Vec3b* row = frame.ptr<cv::Vec3b>(y);
+        for (int x = 0; x < width; ++x) {
+            row[x] = cv::Vec3b(static_cast<uchar>((x + index * 4) & 0xFF),
+                               static_cast<uchar>((y + index * 2) & 0xFF),
+                               static_cast<uchar>((x + y) & 0xFF));
+        }
+    }
+
+    int cx = width / 2 + static_cast<int>(width / 3 * std::sin(index * 0.05));
+    int cy = height / 2 + static_cast<int>(height / 3 * std::cos(index * 0.07));
+    cv::circle(frame, cv::Point(cx, cy), height / 6, cv::Scalar(255, 255, 255), cv::FILLED);
+
+    return frame;
+}
+
+std::vector<cv::Mat> makeSyntheticFrames(int count, int width, int height) {
+    std::vector<cv::Mat> frames;
+    frames.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        frames.push_back(makeSyntheticFrame(i, width, height));
+    }
+
+    return frames;
+}
+
+bool writeSyntheticVideo(const std::string& path, int frameCount, double frameRate) {
+    cv::VideoWriter writer(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), frameRate, cv::Size(1280, 720));
+    if (!writer.isOpened()) {
+        std::cerr << "Error: Could not create synthetic video " << path << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < frameCount; ++i) {
+        writer.write(makeSyntheticFrame(i));
+    }
+
+    writer.release();
+    return true;
+}
+
+bool writeSyntheticAudio(const std::string& path, double seconds) {
+    WavFileAudioSink sink(path);
+    if (!sink.open(AudioDecoder::SAMPLE_RATE, AudioDecoder::CHANNELS)) {
+        return false;
+    }
+
+    const size_t chunkFrames = 1024;
+    size_t totalFrames = static_cast<size_t>(seconds * AudioDecoder::SAMPLE_RATE);
+    std::vector<int16_t> chunk(chunkFrames * AudioDecoder::CHANNELS);
+    const double twoPi = 6.283185307179586;
+    double phase = 0.0;
+
+    for (size_t written = 0; written < totalFrames; written += chunkFrames) {
+        size_t frames = std::min(chunkFrames, totalFrames - written);
+        for (size_t i = 0; i < frames; ++i) {
+            // Sweeps 220 Hz -> 880 Hz over the clip
+            double t = static_cast<double>(written + i) / totalFrames;
+            phase += twoPi * (220.0 + 660.0 * t) / AudioDecoder::SAMPLE_RATE;
+            int16_t sample = static_cast<int16_t>(8000.0 * std::sin(phase));
+            for (int c = 0; c < AudioDecoder::CHANNELS; ++c) {
+                chunk[i * AudioDecoder::CHANNELS + c] = sample;
+            }
+        }
+        if (!sink.write(chunk.data(), frames)) {
+            std::cerr << "Error: Could not write synthetic audio " << path << std::endl;
+            return false;
+        }
+    }
+
+    sink.close();
+    return true;
+}
+
+bool runAudioBenchmark(const std::string& audioPath) {
+    AudioPlayer player(std::unique_ptr<AudioSink>(new NullAudioSink()));
+    auto start = std::chrono::steady_clock::now();
+
+    if (!player.loadAudio(audioPath) || !player.initialize()) {
+        return false;
+    }
+    player.playAudio();
+    player.waitUntilFinished();
+    size_t frames = player.getFramesPlayed();
+    player.stopAudio();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double audioSeconds = static_cast<double>(frames) / AudioDecoder::SAMPLE_RATE;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "Audio benchmark: " << audioSeconds << " s of audio decoded in " << elapsed * 1000.0 << " ms ("
+              << (elapsed > 0 ? audioSeconds / elapsed : 0.0) << "x real time)" << std::endl;
+    return frames > 0;
+}
+
+namespace {
+
+// Only a few distinct frames are kept in memory and cycled through
+const int DISTINCT_FRAMES = 24;
+
+template <typename Convert>
+double millisecondsPerFrame(const std::vector<cv::Mat>& frames, int frameCount, Convert convert) {
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < frameCount; ++i) {
+        bytes += convert(frames[i % frames.size()]);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    // Keep the output size observable so the work can't be optimized away
+    if (bytes == 0) std::cout << "(empty output)" << std::endl;
+
+    return std::chrono::duration<double, std::milli>(elapsed).count() / frameCount;
+}
+
+}
+
+void runConverterBenchmark(int frameWidth, int frameCount) {
+    if (frameWidth <= 0 || frameCount <= 0) return;
+
+    std::vector<cv::Mat> frames = makeSyntheticFrames(std::min(frameCount, DISTINCT_FRAMES));
+
+    struct Mode {
+        const char* name;
+        ColorMode colorMode;
+        bool halfBlock;
+    };
+    const Mode modes[] = {
+        {"grayscale", ColorMode::GRAYSCALE, false},
+        {"256-color", ColorMode::ANSI_256, false},
+        {"truecolor", ColorMode::TRUECOLOR, false},
+        {"half-block", ColorMode::TRUECOLOR, true},
+    };
+
+    std::cout << "Converter benchmark: " << frameCount << " frames " << frames[0].cols << "x" << frames[0].rows
+              << " -> width " << frameWidth << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (const Mode& mode : modes) {
+        ASCIIConverter converter(frameWidth, mode.colorMode, mode.halfBlock);
+
+        double multiPass = millisecondsPerFrame(frames, frameCount, [&](const cv::Mat& frame) {
+            return converter.convertFrameToASCIIMultiPass(frame).size();
+        });
+        double fused = millisecondsPerFrame(frames, frameCount, [&](const cv::Mat& frame) {
+            return converter.convertFrameToASCII(frame).size();
+        });
+
+        std::cout << std::setw(12) << mode.name
+                  << "  multi-pass " << multiPass << " ms/frame"
+                  << "  fused " << fused << " ms/frame"
+                  << "  speedup " << multiPass / fused << "x" << std::endl;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+// Synthetic 8-bit BGR frames (moving gradient plus a bouncing disc) so the
+// converter can be measured without any sample media.
+cv::Mat makeSyntheticFrame(int index, int width = 1280, int height = 720);
+std::vector<cv::Mat> makeSyntheticFrames(int count, int width = 1280, int height = 720);
+
+// Encodes synthetic frames to an MJPG .avi, which OpenCV can write without
+// any external codec, so the whole decode path can be benchmarked in CI.
+bool writeSyntheticVideo(const std::string& path, int frameCount, double frameRate);
+
+// Writes a stereo sine sweep through WavFileAudioSink, giving the audio
+// decoder a track to read without any sample media.
+bool writeSyntheticAudio(const std::string& path, double seconds);
+
+// Decodes an audio file through AudioPlayer into a NullAudioSink and prints
+// how much faster than real time the decoder -> buffer -> sink path runs.
+bool runAudioBenchmark(const std::string& audioPath);
+
+// Times the fused converter against the multi-pass OpenCV path for every
+// color mode and prints ms/frame for both.
+void runConverterBenchmark(int frameWidth, int frameCount);
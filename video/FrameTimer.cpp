@@ -0,0 +1,20 @@
+#include "FrameTimer.h"
+#include <thread>
+
+FrameTimer::FrameTimer(double frameRate)
+    : frameBudget(1.0 / (frameRate > 0 ? frameRate : 30.0)), startTime(clock::now()) {}
+
+void FrameTimer::start() {
+    startTime = clock::now();
+}
+
+long long FrameTimer::currentFrame() const {
+    std::chrono::duration<double> elapsed = clock::now() - startTime;
+    return static_cast<long long>(elapsed.count() / frameBudget);
+}
+
+void FrameTimer::sleepUntil(long long frameIndex) const {
+    auto due = startTime + std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>(frameIndex * frameBudget));
+    std::this_thread::sleep_until(due);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+
+// Paces playback against the wall clock rather than sleeping a fixed amount
+// per frame, so slow frames don't push every later frame back and video
+// stays aligned with the audio that started at the same moment.
+class FrameTimer {
+public:
+    FrameTimer(double frameRate);
+
+    void start();
+
+    // Index of the frame that should be on screen right now
+    long long currentFrame() const;
+
+    // Sleeps until frameIndex is due (returns immediately if already late)
+    void sleepUntil(long long frameIndex) const;
+
+    double getFrameBudget() const { return frameBudget; }
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    double frameBudget;
+    clock::time_point startTime;
+};
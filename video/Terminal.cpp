@@ -0,0 +1,58 @@
+#include "Terminal.h"
+#include <csignal>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+volatile std::sig_atomic_t resizePending = 0;
+
+#ifndef _WIN32
+void onWindowChange(int) {
+    resizePending = 1;
+}
+#endif
+
+}
+
+TerminalSize Terminal::querySize() {
+    TerminalSize size = {80, 24};
+
+    #ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+        size.columns = info.srWindow.Right - info.srWindow.Left + 1;
+        size.rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+    #else
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0) {
+        size.columns = ws.ws_col;
+        size.rows = ws.ws_row;
+    }
+    #endif
+
+    return size;
+}
+
+void Terminal::watchResize() {
+    #ifndef _WIN32
+    struct sigaction action = {};
+    action.sa_handler = onWindowChange;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGWINCH, &action, nullptr);
+    #endif
+}
+
+bool Terminal::consumeResize() {
+    if (!resizePending) return false;
+
+    resizePending = 0;
+    return true;
+}
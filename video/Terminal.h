@@ -0,0 +1,18 @@
+#pragma once
+
+struct TerminalSize {
+    int columns;
+    int rows;
+};
+
+class Terminal {
+public:
+    // Falls back to 80x24 when stdout is not a terminal
+    static TerminalSize querySize();
+
+    // Installs a SIGWINCH handler (no-op on Windows, where size is polled instead)
+    static void watchResize();
+
+    // True once after each resize since the last call
+    static bool consumeResize();
+};
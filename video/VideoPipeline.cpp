@@ -0,0 +1,205 @@
+#include "VideoPipeline.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <functional>
+
+namespace {
+
+typedef std::chrono::steady_clock pipeline_clock;
+
+double secondsSince(pipeline_clock::time_point start) {
+    return std::chrono::duration<double>(pipeline_clock::now() - start).count();
+}
+
+void writeU32(std::ofstream& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+}
+
+VideoPipeline::VideoPipeline(const PipelineOptions& options) : options(options) {
+    if (this->options.threads < 1) {
+        this->options.threads = 1;
+    }
+
+    for (int i = 0; i < this->options.threads; ++i) {
+        converters.emplace_back(this->options.frameWidth, this->options.colorMode, this->options.halfBlock);
+        converters.back().setTruecolorBits(this->options.truecolorBits);
+        converters.back().enableTimings(true);
+    }
+}
+
+bool VideoPipeline::run() {
+    cv::VideoCapture capture(options.inputPath);
+    if (!capture.isOpened()) {
+        std::cerr << "Error: Could not open video file " << options.inputPath << std::endl;
+        return false;
+    }
+
+    if (!options.outputPath.empty() && !openCache(capture.get(cv::CAP_PROP_FPS))) {
+        return false;
+    }
+
+    stats = PipelineStats();
+    auto start = pipeline_clock::now();
+
+    // Audio runs decoder -> buffer -> sink on its own threads alongside the frames
+    std::unique_ptr<AudioPlayer> audio;
+    if (!options.audioOutputPath.empty()) {
+        audio = startAudio();
+    }
+
+    size_t batchSize = static_cast<size_t>(options.threads) * FRAMES_PER_THREAD;
+    Batch batches[2];
+    for (Batch& batch : batches) {
+        batch.frames.resize(batchSize);
+        batch.ascii.resize(batchSize);
+    }
+
+    int current = 0;
+    decodeBatch(capture, batches[current]);
+
+    while (batches[current].count > 0) {
+        Batch& converting = batches[current];
+        Batch& decoding = batches[1 - current];
+
+        // Decode the next batch while this one is being converted
+        std::thread convertThread(&VideoPipeline::convertBatch, this, std::ref(converting));
+        decodeBatch(capture, decoding);
+        convertThread.join();
+
+        writeBatch(converting);
+        stats.frames += converting.count;
+        current = 1 - current;
+    }
+
+    closeCache();
+
+    if (audio) {
+        audio->waitUntilFinished();
+        stats.audioFrames = audio->getFramesPlayed();
+        audio->stopAudio();
+    }
+
+    stats.wallSeconds = secondsSince(start);
+
+    for (const ASCIIConverter& converter : converters) {
+        stats.resizeSeconds += converter.getTimings().resizeSeconds;
+        stats.quantizeSeconds += converter.getTimings().quantizeSeconds;
+    }
+
+    return true;
+}
+
+std::unique_ptr<AudioPlayer> VideoPipeline::startAudio() {
+    std::unique_ptr<AudioPlayer> audio(new AudioPlayer(
+        std::unique_ptr<AudioSink>(new WavFileAudioSink(options.audioOutputPath))));
+
+    if (!audio->loadAudio(options.inputPath) || !audio->initialize()) {
+        std::cerr << "Warning: No audio written for " << options.inputPath << std::endl;
+        return nullptr;
+    }
+
+    audio->playAudio();
+    return audio;
+}
+
+int VideoPipeline::decodeBatch(cv::VideoCapture& capture, Batch& batch) {
+    auto start = pipeline_clock::now();
+
+    batch.count = 0;
+    while (batch.count < static_cast<int>(batch.frames.size()) && capture.read(batch.frames[batch.count])) {
+        ++batch.count;
+    }
+
+    stats.decodeSeconds += secondsSince(start);
+    return batch.count;
+}
+
+void VideoPipeline::convertBatch(Batch& batch) {
+    // Each worker owns a converter and takes every n-th frame of the batch
+    auto work = [this, &batch](int worker) {
+        ASCIIConverter& converter = converters[worker];
+        for (int i = worker; i < batch.count; i += options.threads) {
+            batch.ascii[i] = converter.convertFrameToASCII(batch.frames[i]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int worker = 1; worker < options.threads; ++worker) {
+        workers.emplace_back(work, worker);
+    }
+    work(0);
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+bool VideoPipeline::openCache(double frameRate) {
+    cacheFile.open(options.outputPath, std::ios::binary | std::ios::trunc);
+    if (!cacheFile.is_open()) {
+        std::cerr << "Error: Could not open " << options.outputPath << " for writing" << std::endl;
+        return false;
+    }
+
+    cacheFile.write("ASCIIFRM", 8);
+    writeU32(cacheFile, CACHE_VERSION);
+    writeU32(cacheFile, static_cast<uint32_t>(options.frameWidth));
+    writeU32(cacheFile, static_cast<uint32_t>(options.colorMode));
+    writeU32(cacheFile, options.halfBlock ? 1 : 0);
+    writeU32(cacheFile, static_cast<uint32_t>(frameRate * 1000.0));
+    writeU32(cacheFile, 0); // frame count, patched in closeCache
+    return true;
+}
+
+void VideoPipeline::writeBatch(const Batch& batch) {
+    auto start = pipeline_clock::now();
+
+    for (int i = 0; i < batch.count; ++i) {
+        const std::string& frame = batch.ascii[i];
+        stats.outputBytes += frame.size();
+
+        if (cacheFile.is_open()) {
+            writeU32(cacheFile, static_cast<uint32_t>(frame.size()));
+            cacheFile.write(frame.data(), frame.size());
+        }
+    }
+
+    stats.outputSeconds += secondsSince(start);
+}
+
+void VideoPipeline::closeCache() {
+    if (!cacheFile.is_open()) return;
+
+    auto start = pipeline_clock::now();
+    cacheFile.seekp(28);
+    writeU32(cacheFile, static_cast<uint32_t>(stats.frames));
+    cacheFile.close();
+    stats.outputSeconds += secondsSince(start);
+}
+
+void VideoPipeline::printReport(std::ostream& out) const {
+    auto perFrame = [this](double seconds) {
+        return stats.frames > 0 ? seconds * 1000.0 / stats.frames : 0.0;
+    };
+
+    out << std::fixed << std::setprecision(3);
+    out << "Frames:    " << stats.frames << " (width " << options.frameWidth
+        << ", " << options.threads << " threads)" << std::endl;
+    out << "Decode:    " << perFrame(stats.decodeSeconds) << " ms/frame" << std::endl;
+    out << "Resize:    " << perFrame(stats.resizeSeconds) << " ms/frame (cpu)" << std::endl;
+    out << "Quantize:  " << perFrame(stats.quantizeSeconds) << " ms/frame (cpu)" << std::endl;
+    out << "Output:    " << perFrame(stats.outputSeconds) << " ms/frame, "
+        << stats.outputBytes / 1024 << " KiB" << std::endl;
+    if (!options.audioOutputPath.empty()) {
+        out << "Audio:     " << static_cast<double>(stats.audioFrames) / AudioDecoder::SAMPLE_RATE
+            << " s written to " << options.audioOutputPath << std::endl;
+    }
+    out << "Total:     " << stats.wallSeconds << " s, "
+        << (stats.wallSeconds > 0 ? stats.frames / stats.wallSeconds : 0.0) << " frames/sec" << std::endl;
+}
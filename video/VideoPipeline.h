@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ASCIIConverter.h"
+#include "AudioPlayer.h"
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct PipelineOptions {
+    std::string inputPath;
+    std::string outputPath; // empty: frames are converted but not stored
+    int frameWidth = 150;
+    int threads = 1;
+    ColorMode colorMode = ColorMode::GRAYSCALE;
+    bool halfBlock = false;
+    int truecolorBits = 8;
+    std::string audioOutputPath; // non-empty: the audio track is also decoded into this WAV file
+};
+
+struct PipelineStats {
+    int frames = 0;
+    size_t outputBytes = 0;
+    double decodeSeconds = 0.0;
+    double resizeSeconds = 0.0;   // summed over worker threads
+    double quantizeSeconds = 0.0; // summed over worker threads
+    double outputSeconds = 0.0;
+    double wallSeconds = 0.0;
+    size_t audioFrames = 0;
+};
+
+// Headless decode -> convert -> encode without a terminal. The main thread
+// decodes the next batch while worker threads convert the current one, then
+// writes the converted batch in order to a frame cache file:
+//
+//   "ASCIIFRM" | u32 version | u32 width | u32 colorMode | u32 halfBlock
+//   | u32 fps * 1000 | u32 frameCount | { u32 length | bytes } * frameCount
+class VideoPipeline {
+public:
+    VideoPipeline(const PipelineOptions& options);
+
+    bool run();
+    const PipelineStats& getStats() const { return stats; }
+    void printReport(std::ostream& out) const;
+
+private:
+    static const int FRAMES_PER_THREAD = 8;
+    static const uint32_t CACHE_VERSION = 1;
+
+    struct Batch {
+        std::vector<cv::Mat> frames;
+        std::vector<std::string> ascii;
+        int count = 0;
+    };
+
+    PipelineOptions options;
+    PipelineStats stats;
+    std::vector<ASCIIConverter> converters;
+    std::ofstream cacheFile;
+
+    std::unique_ptr<AudioPlayer> startAudio();
+    int decodeBatch(cv::VideoCapture& capture, Batch& batch);
+    void convertBatch(Batch& batch);
+    bool openCache(double frameRate);
+    void writeBatch(const Batch& batch);
+    void closeCache();
+};
@@ -1,14 +1,173 @@
 #include "ASCIIVideoPlayer.h"
+#include "ConverterBenchmark.h"
+#include "VideoPipeline.h"
 #include <iostream>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
 
-int main() {
+void printUsage(const std::string& programName) {
+    std::cout << "Usage: " << programName << " [options]\n";
+    std::cout << "  (no options)                        - Interactive player menu\n";
+    std::cout << "  --convert <in> --out <file>         - Convert a video to a frame cache without a terminal\n";
+    std::cout << "  --bench                             - Run the pipeline on a generated video and report timings\n";
+    std::cout << "  --bench-converter [width]           - Compare fused and multi-pass conversion\n";
+    std::cout << "Options for --convert and --bench:\n";
+    std::cout << "  --width <N>                         - Output width in characters (default 150)\n";
+    std::cout << "  --threads <N>                       - Conversion threads (default: all cores)\n";
+    std::cout << "  --color <gray|256|truecolor|halfblock>\n";
+    std::cout << "  --color-bits <1-8>                  - Truecolor bits per channel; fewer merge more cells (default 8)\n";
+    std::cout << "  --audio-out <file.wav>              - Also decode the audio track to a WAV file (--convert only)\n";
+    std::cout << "  --frames <N>                        - Frames in the generated video (--bench only, default 300)\n";
+}
+
+// Widths, thread and frame counts must all be at least 1
+bool parsePositive(const std::string& value, int& out) {
+    out = std::stoi(value);
+    return out > 0;
+}
+
+bool parseColor(const std::string& value, PipelineOptions& options) {
+    if (value == "gray") {
+        options.colorMode = ColorMode::GRAYSCALE;
+    } else if (value == "256") {
+        options.colorMode = ColorMode::ANSI_256;
+    } else if (value == "truecolor") {
+        options.colorMode = ColorMode::TRUECOLOR;
+    } else if (value == "halfblock") {
+        options.colorMode = ColorMode::TRUECOLOR;
+        options.halfBlock = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+int runBenchmark(PipelineOptions options, int frameCount) {
+    // A random suffix keeps concurrent runs on one machine from clobbering each other's files
+    std::filesystem::path base = std::filesystem::temp_directory_path() /
+                                 ("ascii-bench-" + std::to_string(std::random_device{}()));
+    std::string videoPath = base.string() + ".avi";
+    std::string cachePath = base.string() + ".cache";
+    std::string audioPath = base.string() + ".wav";
+
+    std::cout << "Generating " << frameCount << " synthetic frames..." << std::endl;
+    if (!writeSyntheticVideo(videoPath, frameCount, 30.0)) {
+        return 1;
+    }
+
+    options.inputPath = videoPath;
+    options.outputPath = cachePath;
+
+    VideoPipeline pipeline(options);
+    bool ok = pipeline.run();
+    if (ok) {
+        pipeline.printReport(std::cout);
+        std::cout << std::endl;
+        runConverterBenchmark(options.frameWidth, frameCount);
+        std::cout << std::endl;
+
+        // The synthetic video has no audio track, so the audio path gets its own clip
+        ok = writeSyntheticAudio(audioPath, frameCount / 30.0) && runAudioBenchmark(audioPath);
+    }
+
+    std::remove(videoPath.c_str());
+    std::remove(cachePath.c_str());
+    std::remove(audioPath.c_str());
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
     try {
-        ASCIIVideoPlayer player;
-        player.showMenu();
+        if (argc < 2) {
+            ASCIIVideoPlayer player;
+            player.showMenu();
+            return 0;
+        }
+
+        std::string mode = argv[1];
+
+        if (mode == "--bench-converter") {
+            int width = 150;
+            if (argc >= 3 && !parsePositive(argv[2], width)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            runConverterBenchmark(width, 200);
+            return 0;
+        }
+
+        if (mode != "--convert" && mode != "--bench") {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        PipelineOptions options;
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+        int frameCount = 300;
+        int first = 2;
+
+        if (mode == "--convert") {
+            if (argc < 3) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.inputPath = argv[2];
+            first = 3;
+        }
+
+        for (int i = first; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            std::string value = argv[++i];
+
+            bool valid = true;
+            if (arg == "--out") {
+                options.outputPath = value;
+            } else if (arg == "--width") {
+                valid = parsePositive(value, options.frameWidth);
+            } else if (arg == "--threads") {
+                valid = parsePositive(value, options.threads);
+            } else if (arg == "--frames") {
+                valid = parsePositive(value, frameCount);
+            } else if (arg == "--color-bits") {
+                valid = parsePositive(value, options.truecolorBits) && options.truecolorBits <= 8;
+            } else if (arg == "--audio-out" && mode == "--convert") {
+                options.audioOutputPath = value;
+            } else if (arg != "--color" || !parseColor(value, options)) {
+                valid = false;
+            }
+
+            if (!valid) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (mode == "--bench") {
+            return runBenchmark(options, frameCount);
+        }
+
+        if (options.outputPath.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        VideoPipeline pipeline(options);
+        if (!pipeline.run()) {
+            return 1;
+        }
+        pipeline.printReport(std::cout);
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-    
+
     return 0;
-}
\ No newline at end of file
+}